@@ -47,6 +47,12 @@ BacktraceWidget::BacktraceWidget(BacktraceGenerator *generator, QWidget *parent,
     connect(m_btGenerator, &BacktraceGenerator::someError, this, &BacktraceWidget::loadData);
     connect(m_btGenerator, &BacktraceGenerator::failedToStart, this, &BacktraceWidget::loadData);
     connect(m_btGenerator, &BacktraceGenerator::newLine, this, &BacktraceWidget::backtraceNewLine);
+    connect(m_btGenerator->parser(), &BacktraceParser::ratingDataChanged, this, [this] {
+        // show the rating of the threads received so far while the debugger is still running
+        if (m_btGenerator->state() == BacktraceGenerator::Loading) {
+            m_backtraceRatingWidget->setUsefulness(m_btGenerator->parser()->backtraceUsefulness());
+        }
+    });
 
     connect(ui.m_extraDetailsLabel, &QLabel::linkActivated, this, &BacktraceWidget::extraDetailsLinkActivated);
     ui.m_extraDetailsLabel->setVisible(false);
@@ -0,0 +1,122 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "bugbacktracecache.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include "drkonqi_debug.h"
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+constexpr quint32 MAGIC = 0x44524254; // DRBT
+// Bump when the format (or the signatures it holds) change, older files are then simply ignored.
+constexpr quint32 VERSION = 3;
+constexpr QDataStream::Version STREAM_VERSION = QDataStream::Qt_6_5;
+} // namespace
+
+BugBacktraceCache::BugBacktraceCache(const QString &directory)
+    : m_directory(directory)
+{
+}
+
+QString BugBacktraceCache::defaultDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/bugbacktraces"_L1;
+}
+
+QString BugBacktraceCache::filePath(qint64 bugId) const
+{
+    return m_directory + "/%1"_L1.arg(bugId);
+}
+
+std::optional<BugBacktraceCache::Entry> BugBacktraceCache::lookup(qint64 bugId, const QDateTime &lastChangeTime) const
+{
+    if (!lastChangeTime.isValid()) {
+        return std::nullopt;
+    }
+
+    QFile file(filePath(bugId));
+    if (!file.open(QFile::ReadOnly)) {
+        return std::nullopt;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(STREAM_VERSION);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if (magic != MAGIC || version != VERSION) {
+        return std::nullopt;
+    }
+
+    Entry entry;
+    qint64 commentCount = 0;
+    stream >> entry.lastChangeTime >> commentCount;
+    if (stream.status() != QDataStream::Ok || entry.lastChangeTime != lastChangeTime) {
+        return std::nullopt;
+    }
+    entry.commentCount = commentCount;
+
+    // The symbol ids are only valid within this process, the function names are stored instead.
+    quint32 signatureCount = 0;
+    stream >> signatureCount;
+    for (quint32 i = 0; i < signatureCount && stream.status() == QDataStream::Ok; ++i) {
+        quint32 frameCount = 0;
+        ParseBugBacktraces::Signature signature;
+        stream >> frameCount >> signature.blockEnded;
+        for (quint32 j = 0; j < frameCount && stream.status() == QDataStream::Ok; ++j) {
+            qint32 number = -1;
+            QString function;
+            QString normalizedFunction;
+            stream >> number >> function >> normalizedFunction;
+            signature.frames.append({number, SymbolTable::intern(function), SymbolTable::intern(normalizedFunction)});
+        }
+        entry.signatures.append(signature);
+    }
+
+    if (stream.status() != QDataStream::Ok || !stream.atEnd()) {
+        qCWarning(DRKONQI_LOG) << "Ignoring corrupt backtrace cache of bug" << bugId;
+        return std::nullopt;
+    }
+    return entry;
+}
+
+void BugBacktraceCache::insert(qint64 bugId, const Entry &entry) const
+{
+    if (!entry.lastChangeTime.isValid()) {
+        return;
+    }
+
+    QDir().mkpath(m_directory);
+    // Written atomically, a concurrent lookup either sees the old or the new entry.
+    QSaveFile file(filePath(bugId));
+    if (!file.open(QFile::WriteOnly)) {
+        qCWarning(DRKONQI_LOG) << "Failed to write backtrace cache of bug" << bugId << file.errorString();
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(STREAM_VERSION);
+    stream << MAGIC << VERSION << entry.lastChangeTime << qint64(entry.commentCount);
+    stream << quint32(entry.signatures.size());
+    for (const ParseBugBacktraces::Signature &signature : entry.signatures) {
+        stream << quint32(signature.frames.size()) << signature.blockEnded;
+        for (const ParseBugBacktraces::Frame &frame : signature.frames) {
+            stream << qint32(frame.number) << SymbolTable::name(frame.function) << SymbolTable::name(frame.normalizedFunction);
+        }
+    }
+
+    if (!file.commit()) {
+        qCWarning(DRKONQI_LOG) << "Failed to write backtrace cache of bug" << bugId << file.errorString();
+    }
+}
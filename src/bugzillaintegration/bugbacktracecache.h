@@ -0,0 +1,59 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QDateTime>
+#include <QList>
+#include <QString>
+
+#include <optional>
+
+#include "parsebugbacktraces.h"
+
+/**
+ * Persistent cache of the backtrace signatures parsed out of the comments of bugs,
+ * so that looking at a bug again needs neither its comments fetched nor parsed.
+ *
+ * There is one file per bug, it is only valid for the last_change_time of the
+ * bug it was written for. Any change to the bug (e.g. a new comment) therefore
+ * invalidates it.
+ *
+ * The cache has no state besides its directory, it may be copied to and used from
+ * any thread.
+ */
+class BugBacktraceCache
+{
+public:
+    struct Entry {
+        // of the bug when its comments were fetched
+        QDateTime lastChangeTime;
+        qsizetype commentCount = 0;
+        QList<ParseBugBacktraces::Signature> signatures;
+    };
+
+    /**
+     * @param directory where the cache files are kept, it is created when needed
+     */
+    explicit BugBacktraceCache(const QString &directory = defaultDirectory());
+
+    static QString defaultDirectory();
+
+    /**
+     * @return the cached entry of bugId if it was written for lastChangeTime, nothing if there is
+     *   no such entry or it is unreadable
+     */
+    std::optional<Entry> lookup(qint64 bugId, const QDateTime &lastChangeTime) const;
+
+    /**
+     * Replaces the entry of bugId. Entries without a valid lastChangeTime are not cached.
+     */
+    void insert(qint64 bugId, const Entry &entry) const;
+
+private:
+    QString filePath(qint64 bugId) const;
+
+    QString m_directory;
+};
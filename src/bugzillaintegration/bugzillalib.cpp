@@ -12,6 +12,7 @@
 
 #include <QReadWriteLock>
 #include <QRegularExpression>
+#include <QStandardPaths>
 
 #include "drkonqi_debug.h"
 #include "libbugzilla/bugzilla.h"
@@ -19,6 +20,23 @@
 #include "libbugzilla/connection.h"
 
 static const char showBugUrl[] = "show_bug.cgi?id=%1";
+// The duplicate search fetches comments in bursts, they share a few warm connections rather than opening
+// Qt's default of six per report to a server that isn't ours.
+static constexpr int maxConnections = 4;
+
+// The fields of bugs fetched to list and check possible duplicates, see DuplicateModel and DuplicateFinderJob.
+// The rest of a bug is of no interest there and would only bloat the responses.
+static QStringList duplicateFields()
+{
+    return {
+        QStringLiteral("id"),
+        QStringLiteral("summary"),
+        QStringLiteral("status"),
+        QStringLiteral("resolution"),
+        QStringLiteral("dupe_of"),
+        QStringLiteral("last_change_time"),
+    };
+}
 
 // Extra filter rigging. We don't want to leak secrets via qdebug, so install
 // a message handler which does nothing more than replace secrets in debug
@@ -86,7 +104,11 @@ BugzillaManager::BugzillaManager(const QString &bugTrackerUrl, QObject *parent)
     , m_bugTrackerUrl(bugTrackerUrl.isEmpty() ? KDE_BUGZILLA_URL : bugTrackerUrl)
 {
     Q_ASSERT(bugTrackerUrl.endsWith(QLatin1Char('/')));
-    Bugzilla::setConnection(new Bugzilla::HTTPConnection(QUrl(m_bugTrackerUrl + QStringLiteral("rest"))));
+    auto connection = new Bugzilla::HTTPConnection(QUrl(m_bugTrackerUrl + QStringLiteral("rest")));
+    connection->setMaxConnections(maxConnections);
+    // Product and field information rarely changes, it is revalidated rather than fetched for every report.
+    connection->setCacheDirectory(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/bugzilla"));
+    Bugzilla::setConnection(connection);
 }
 
 void BugzillaManager::lookupVersion()
@@ -186,10 +208,11 @@ QString BugzillaManager::getUsername() const
     return m_username;
 }
 
-void BugzillaManager::fetchBugReport(int bugnumber, QObject *jobOwner)
+KJob *BugzillaManager::fetchBugReport(int bugnumber, QObject *jobOwner)
 {
     Bugzilla::BugSearch search;
     search.id = bugnumber;
+    search.include_fields = duplicateFields();
 
     Bugzilla::BugClient client;
     auto job = m_searchJob = client.search(search);
@@ -207,9 +230,10 @@ void BugzillaManager::fetchBugReport(int bugnumber, QObject *jobOwner)
             Q_EMIT bugReportError(e.whatString(), jobOwner);
         }
     });
+    return job;
 }
 
-void BugzillaManager::fetchComments(const Bugzilla::Bug::Ptr &bug, QObject *jobOwner)
+KJob *BugzillaManager::fetchComments(const Bugzilla::Bug::Ptr &bug, QObject *jobOwner)
 {
     Bugzilla::CommentClient client;
     auto job = client.getFromBug(bug->id());
@@ -222,6 +246,26 @@ void BugzillaManager::fetchComments(const Bugzilla::Bug::Ptr &bug, QObject *jobO
             Q_EMIT commentsError(e.whatString(), jobOwner);
         }
     });
+    return job;
+}
+
+KJob *BugzillaManager::fetchComments(const QList<int> &bugIds, QObject *jobOwner)
+{
+    Bugzilla::CommentClient client;
+    auto job = client.getFromBugs(bugIds);
+    connect(qobject_cast<Bugzilla::APIJob *>(job), &Bugzilla::APIJob::valueRead, this, [this, jobOwner](const QString &key, const QJsonValue &value) {
+        Q_EMIT bugCommentsFetched(key.toInt(), Bugzilla::CommentClient::commentsOf(value.toObject()), jobOwner);
+    });
+    connect(job, &KJob::finished, this, [this, client, jobOwner](KJob *job) {
+        try {
+            auto comments = client.getFromBugs(job);
+            Q_EMIT bugsCommentsFetched(comments, jobOwner);
+        } catch (Bugzilla::Exception &e) {
+            qCWarning(DRKONQI_LOG) << e.whatString();
+            Q_EMIT commentsError(e.whatString(), jobOwner);
+        }
+    });
+    return job;
 }
 
 // TODO: This would kinda benefit from an actual pagination class,
@@ -241,6 +285,7 @@ void BugzillaManager::searchBugs(const QStringList &products, const QString &sev
     search.order << QStringLiteral("bug_id DESC");
     search.limit = 25;
     search.offset = offset;
+    search.include_fields = duplicateFields();
 
     stopCurrentSearch();
 
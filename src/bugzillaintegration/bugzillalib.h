@@ -42,7 +42,9 @@ public:
     QString getUsername() const;
 
     /* Bugzilla Action methods */
-    void fetchBugReport(int, QObject *jobOwner = nullptr);
+    // Both only fetch the fields needed to list and check duplicates (id,
+    // summary, status, resolution, dupe_of and last_change_time).
+    KJob *fetchBugReport(int, QObject *jobOwner = nullptr);
     Q_INVOKABLE void searchBugs(const QStringList &products, const QString &severity, const QString &comment, int offset);
     void sendReport(const Bugzilla::NewBug &bug);
     void attachTextToReport(const QString &text, const QString &filename, const QString &description, int bugId, const QString &comment);
@@ -53,7 +55,12 @@ public:
     QString urlForBug(int bug_number) const;
     void stopCurrentSearch();
 
-    void fetchComments(const Bugzilla::Bug::Ptr &bug, QObject *jobOwner);
+    KJob *fetchComments(const Bugzilla::Bug::Ptr &bug, QObject *jobOwner);
+    // Fetches the comments of several bugs in one request. Each bug is
+    // reported through bugCommentsFetched as soon as it is received,
+    // bugsCommentsFetched concludes the request with the bugs that weren't
+    // reported yet. Bugs the server didn't answer for are reported by neither.
+    KJob *fetchComments(const QList<int> &bugIds, QObject *jobOwner);
     Q_SCRIPTABLE void lookupVersion();
 
 Q_SIGNALS:
@@ -61,6 +68,8 @@ Q_SIGNALS:
     void loginFinished(bool logged);
     void bugReportFetched(Bugzilla::Bug::Ptr bug, QObject *jobOwner);
     void commentsFetched(QList<Bugzilla::Comment::Ptr> comments, QObject *jobOwner);
+    void bugCommentsFetched(int bugId, QList<Bugzilla::Comment::Ptr> comments, QObject *jobOwner);
+    void bugsCommentsFetched(QHash<int, QList<Bugzilla::Comment::Ptr>> comments, QObject *jobOwner);
     void searchFinished(const QList<Bugzilla::Bug::Ptr> &bug);
     void reportSent(int bugId);
     void attachToReportSent(int bugId);
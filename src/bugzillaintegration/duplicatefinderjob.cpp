@@ -9,13 +9,66 @@
 
 #include "duplicatefinderjob.h"
 
+#include <QHash>
+#include <QPointer>
 #include <QtConcurrent>
 
+#include <algorithm>
+#include <optional>
+
 #include "backtracegenerator.h"
 #include "debuggermanager.h"
 #include "drkonqi.h"
 #include "drkonqi_debug.h"
+#include "duplicateindex.h"
 #include "parser/backtraceparser.h"
+#include "parser/symboltable.h"
+
+namespace
+{
+// Bugs whose comments are fetched (and parsed) at the same time. The comments of the
+// candidates added at once are fetched in a single request.
+constexpr qsizetype MAX_CANDIDATES_IN_FLIGHT = 8;
+
+// Whether a perfect duplicate with this bug settles the search, i.e. neither its
+// parent has to be looked at nor the bugs after it.
+bool isFinalDuplicate(const Bugzilla::Bug::Ptr &bug)
+{
+    return bug->status() != Bugzilla::Bug::Status::Unknown && bug->resolution() != Bugzilla::Bug::Resolution::Unknown
+        && bug->resolution() != Bugzilla::Bug::Resolution::DUPLICATE;
+}
+} // namespace
+
+/**
+ * A bug being analyzed. It is the jobOwner of its BugzillaManager requests,
+ * which tells the results of concurrent requests apart.
+ */
+class DuplicateFinderJob::Candidate : public QObject
+{
+public:
+    using QObject::QObject;
+
+    Bugzilla::Bug::Ptr bug = nullptr;
+    // the pending request, to cancel it when the result doesn't matter anymore
+    QPointer<KJob> job;
+    // alternatively the batch whose request fetches our comments
+    Batch *batch = nullptr;
+    // set once the comments were fetched and parsed
+    std::optional<ParseBugBacktraces::DuplicateRating> rating;
+};
+
+/**
+ * Candidates whose comments are fetched in one request, the jobOwner of that request.
+ */
+class DuplicateFinderJob::Batch : public QObject
+{
+public:
+    using QObject::QObject;
+
+    // still pending, cancelled candidates leave the batch
+    QList<Candidate *> candidates;
+    QPointer<KJob> job;
+};
 
 DuplicateFinderJob::DuplicateFinderJob(const QList<Bugzilla::Bug::Ptr> &bugs, BugzillaManager *manager, QObject *parent)
     : KJob(parent)
@@ -27,9 +80,20 @@ DuplicateFinderJob::DuplicateFinderJob(const QList<Bugzilla::Bug::Ptr> &bugs, Bu
     connect(m_manager, &BugzillaManager::bugReportError, this, &DuplicateFinderJob::slotError);
 
     connect(m_manager, &BugzillaManager::commentsFetched, this, &DuplicateFinderJob::slotCommentsFetched);
+    connect(m_manager, &BugzillaManager::bugCommentsFetched, this, &DuplicateFinderJob::slotBugCommentsFetched);
+    connect(m_manager, &BugzillaManager::bugsCommentsFetched, this, &DuplicateFinderJob::slotBugsCommentsFetched);
     connect(m_manager, &BugzillaManager::commentsError, this, &DuplicateFinderJob::slotError);
 }
 
+DuplicateFinderJob::DuplicateFinderJob(const StructuredBacktrace &backtrace,
+                                       const QList<Bugzilla::Bug::Ptr> &bugs,
+                                       BugzillaManager *manager,
+                                       QObject *parent)
+    : DuplicateFinderJob(bugs, manager, parent)
+{
+    m_ourTrace = backtrace;
+}
+
 DuplicateFinderJob::~DuplicateFinderJob() = default;
 
 void DuplicateFinderJob::start()
@@ -39,7 +103,13 @@ void DuplicateFinderJob::start()
         return;
     }
 
-    analyzeNextBug();
+    if (!m_ourTrace) {
+        BacktraceGenerator *btGenerator = DrKonqi::debuggerManager()->backtraceGenerator();
+        m_ourTrace = btGenerator->parser()->structuredBacktrace();
+    }
+
+    prioritizeIndexedDuplicates();
+    fillPipeline();
 }
 
 DuplicateFinderJob::Result DuplicateFinderJob::result() const
@@ -47,117 +117,397 @@ DuplicateFinderJob::Result DuplicateFinderJob::result() const
     return m_result;
 }
 
-void DuplicateFinderJob::analyzeNextBug()
+DuplicateFinderJob::Candidate *DuplicateFinderJob::candidateFor(QObject *owner) const
+{
+    // Requests of cancelled candidates may still report back, they are not pending anymore.
+    for (Candidate *candidate : m_pending) {
+        if (candidate == owner) {
+            return candidate;
+        }
+    }
+    return nullptr;
+}
+
+DuplicateFinderJob::Batch *DuplicateFinderJob::batchFor(QObject *owner) const
 {
-    if (m_bugs.isEmpty()) {
-        emitResult();
+    for (Batch *batch : m_batches) {
+        if (batch == owner) {
+            return batch;
+        }
+    }
+    return nullptr;
+}
+
+void DuplicateFinderJob::prioritizeIndexedDuplicates()
+{
+    // Bugs known to have a backtrace like ours go first. Their ratings are usually cached as well,
+    // so an exact duplicate settles the search before any request goes out.
+    const QList<DuplicateIndex::Match> matches = DuplicateIndex::instance().lookup(CrashSignature::fromBacktrace(*m_ourTrace));
+    if (matches.isEmpty()) {
         return;
     }
 
-    m_bug = m_bugs.takeFirst();
-    qCDebug(DRKONQI_LOG) << "Fetching:" << m_bug->id();
-    m_manager->fetchComments(m_bug, this);
+    QHash<qint64, qsizetype> ranks;
+    for (qsizetype i = 0; i < matches.size(); ++i) {
+        ranks.insert(matches.at(i).bugId, i);
+    }
+    const auto rank = [&ranks](const Bugzilla::Bug::Ptr &bug) {
+        return ranks.value(bug->id(), ranks.size());
+    };
+    std::stable_sort(m_bugs.begin(), m_bugs.end(), [&rank](const Bugzilla::Bug::Ptr &a, const Bugzilla::Bug::Ptr &b) {
+        return rank(a) < rank(b);
+    });
+    qCDebug(DRKONQI_LOG) << "Indexed duplicates:" << matches.size() << "first candidate:" << (m_bugs.isEmpty() ? 0 : m_bugs.constFirst()->id());
 }
 
-void DuplicateFinderJob::fetchBug(int bugId)
+void DuplicateFinderJob::fillPipeline()
 {
-    if (bugId > 0) {
-        qCDebug(DRKONQI_LOG) << "Fetching:" << bugId;
-        m_manager->fetchBugReport(bugId, this);
-    } else {
-        qCDebug(DRKONQI_LOG) << "Bug id not valid:" << bugId;
-        analyzeNextBug();
+    QList<Candidate *> candidates;
+    while (!m_decided && m_pending.size() < MAX_CANDIDATES_IN_FLIGHT && !m_bugs.isEmpty()) {
+        auto candidate = new Candidate(this);
+        candidate->bug = m_bugs.takeFirst();
+        m_pending.append(candidate);
+        candidates.append(candidate);
+    }
+    if (!candidates.isEmpty()) {
+        analyze(candidates);
+    }
+
+    if (m_pending.isEmpty()) {
+        finish();
     }
 }
 
 void DuplicateFinderJob::slotBugReportFetched(const Bugzilla::Bug::Ptr &bug, QObject *owner)
 {
-    if (this != owner) {
+    Candidate *candidate = candidateFor(owner);
+    if (!candidate) {
         return;
     }
 
-    m_bug = bug;
-    qCDebug(DRKONQI_LOG) << "Fetching:" << m_bug->id();
-    m_manager->fetchComments(m_bug, this);
+    candidate->job = nullptr;
+    candidate->bug = bug;
+    analyze({candidate});
+}
+
+void DuplicateFinderJob::analyze(const QList<Candidate *> &candidates)
+{
+    // A bug that didn't change since it was last looked at needs neither be fetched nor parsed again.
+    // All candidates are looked up in one go, the ones that aren't cached are then fetched together.
+    struct Lookup {
+        qint64 bugId;
+        QDateTime lastChangeTime;
+    };
+    QList<Lookup> lookups;
+    QList<QPointer<Candidate>> guards;
+    for (Candidate *candidate : candidates) {
+        lookups.append({candidate->bug->id(), candidate->bug->last_change_time()});
+        guards.append(candidate);
+    }
+
+    auto watcher = new QFutureWatcher<QList<std::optional<Analysis>>>(this);
+    connect(watcher, &std::remove_pointer_t<decltype(watcher)>::finished, this, [this, guards, watcher] {
+        // runs on our thread again
+        watcher->deleteLater();
+        const QList<std::optional<Analysis>> results = watcher->result();
+        QList<Candidate *> misses;
+        bool rated = false;
+        for (qsizetype i = 0; i < guards.size(); ++i) {
+            // cancelled meanwhile
+            Candidate *candidate = candidateFor(guards.at(i));
+            if (!candidate) {
+                continue;
+            }
+            if (results.at(i)) {
+                rated = true;
+                rate(candidate, *results.at(i));
+            } else {
+                misses.append(candidate);
+            }
+        }
+        if (!misses.isEmpty()) {
+            fetchComments(misses);
+        }
+        if (rated) {
+            processResults();
+        }
+    });
+    watcher->setFuture(QtConcurrent::run([lookups, cache = m_cache, ourTrace = *m_ourTrace] {
+        // the names of the bugs' backtraces are forgotten again once they are rated
+        SymbolTable::Session symbols;
+        QList<std::optional<Analysis>> results;
+        results.reserve(lookups.size());
+        for (const Lookup &lookup : lookups) {
+            const std::optional<BugBacktraceCache::Entry> entry = cache.lookup(lookup.bugId, lookup.lastChangeTime);
+            if (!entry) {
+                results.append(std::nullopt);
+                continue;
+            }
+            ParseBugBacktraces parse(entry->signatures);
+            results.append(Analysis{parse.findDuplicate(ourTrace), parse.similarity(ourTrace)});
+        }
+        return results;
+    }));
+}
+
+void DuplicateFinderJob::analyzeAsync(Candidate *candidate, std::function<Analysis()> analysis)
+{
+    // QFuture the parsing. We'll not want to block the GUI thread with this nonesense.
+    // The watcher belongs to the candidate, a cancelled candidate's result is simply dropped.
+    auto watcher = new QFutureWatcher<Analysis>(candidate);
+    connect(watcher, &std::remove_pointer_t<decltype(watcher)>::finished, this, [this, candidate, watcher] {
+        // runs on our thread again
+        watcher->deleteLater();
+        // Cancelled candidates are only deleted later, a result that was already queued still arrives.
+        if (!m_pending.contains(candidate)) {
+            return;
+        }
+        rate(candidate, watcher->result());
+        processResults();
+    });
+    watcher->setFuture(QtConcurrent::run(std::move(analysis)));
+}
+
+void DuplicateFinderJob::rate(Candidate *candidate, const Analysis &analysis)
+{
+    candidate->rating = analysis.rating;
+    qCDebug(DRKONQI_LOG) << "Duplicate rating of" << candidate->bug->id() << ":" << analysis.rating << "similarity:" << analysis.similarity;
+    Q_EMIT similarityScored(candidate->bug->id(), analysis.similarity);
+    if (*candidate->rating == ParseBugBacktraces::PerfectDuplicate && isFinalDuplicate(candidate->bug)) {
+        cancelAfter(candidate);
+    }
+}
+
+void DuplicateFinderJob::fetchComments(const QList<Candidate *> &candidates)
+{
+    if (candidates.size() == 1) {
+        Candidate *candidate = candidates.constFirst();
+        qCDebug(DRKONQI_LOG) << "Fetching:" << candidate->bug->id();
+        candidate->job = m_manager->fetchComments(candidate->bug, candidate);
+        return;
+    }
+
+    auto batch = new Batch(this);
+    QList<int> bugIds;
+    for (Candidate *candidate : candidates) {
+        candidate->batch = batch;
+        batch->candidates.append(candidate);
+        bugIds.append(candidate->bug->id());
+    }
+    m_batches.append(batch);
+    qCDebug(DRKONQI_LOG) << "Fetching:" << bugIds;
+    batch->job = m_manager->fetchComments(bugIds, batch);
+}
+
+void DuplicateFinderJob::slotBugCommentsFetched(int bugId, const QList<Bugzilla::Comment::Ptr> &comments, QObject *owner)
+{
+    Batch *batch = batchFor(owner);
+    if (!batch) {
+        return;
+    }
+
+    // the rest of the batch is still being received, this one can be parsed already
+    for (Candidate *candidate : std::as_const(batch->candidates)) {
+        if (candidate->bug->id() == bugId) {
+            batch->candidates.removeOne(candidate);
+            candidate->batch = nullptr;
+            parseComments(candidate, comments);
+            return;
+        }
+    }
+}
+
+void DuplicateFinderJob::slotBugsCommentsFetched(const QHash<int, QList<Bugzilla::Comment::Ptr>> &comments, QObject *owner)
+{
+    Batch *batch = takeBatch(owner);
+    if (!batch) {
+        return;
+    }
+
+    QList<Candidate *> missing;
+    for (Candidate *candidate : std::as_const(batch->candidates)) {
+        const auto it = comments.constFind(candidate->bug->id());
+        if (it == comments.constEnd()) {
+            missing.append(candidate);
+            continue;
+        }
+        parseComments(candidate, *it);
+    }
+
+    // the server didn't answer for every bug, ask for those one by one
+    for (Candidate *candidate : std::as_const(missing)) {
+        fetchComments({candidate});
+    }
 }
 
 void DuplicateFinderJob::slotCommentsFetched(const QList<Bugzilla::Comment::Ptr> &comments, QObject *owner)
 {
-    if (this != owner) {
+    Candidate *candidate = candidateFor(owner);
+    if (!candidate) {
         return;
     }
+    candidate->job = nullptr;
+    parseComments(candidate, comments);
+}
 
+DuplicateFinderJob::Batch *DuplicateFinderJob::takeBatch(QObject *owner)
+{
+    Batch *batch = batchFor(owner);
+    if (!batch) {
+        return nullptr;
+    }
+    m_batches.removeOne(batch);
+    batch->deleteLater();
+    for (Candidate *candidate : std::as_const(batch->candidates)) {
+        candidate->batch = nullptr;
+    }
+    return batch;
+}
+
+void DuplicateFinderJob::parseComments(Candidate *candidate, const QList<Bugzilla::Comment::Ptr> &comments)
+{
     // NOTE: we do not hold the comments in our bug object, once they go out
     //   of scope they are gone again. We have no use for keeping them in memory
     //   a user might look at 3 out of 20 bugs, and for those we can simply
     //   request the comments again instead of holding the potentially very large
     //   comments in memory.
 
-    BacktraceGenerator *btGenerator = DrKonqi::debuggerManager()->backtraceGenerator();
-    const QList<BacktraceLine> ourTraceLines = btGenerator->parser()->parsedBacktraceLines();
-
-    // QFuture the parsing. We'll not want to block the GUI thread with this nonesense.
-    auto watcher = new QFutureWatcher<ParseBugBacktraces::DuplicateRating>(this);
-    connect(watcher, &std::remove_pointer_t<decltype(watcher)>::finished, this, [this, watcher] {
-        // runs on our thread again
-        watcher->deleteLater();
-        commentsParsed(watcher->result());
-    });
-    auto future = QtConcurrent::run([comments, ourTraceLines]() -> ParseBugBacktraces::DuplicateRating {
-        ParseBugBacktraces parse(comments);
-        parse.parse();
-        return parse.findDuplicate(ourTraceLines);
-    });
-    watcher->setFuture(future);
+    analyzeAsync(candidate,
+                 [comments,
+                  cache = m_cache,
+                  bugId = candidate->bug->id(),
+                  lastChangeTime = candidate->bug->last_change_time(),
+                  ourTrace = *m_ourTrace] {
+                     SymbolTable::Session symbols;
+                     ParseBugBacktraces parse(comments);
+                     parse.parse();
+                     cache.insert(bugId, {lastChangeTime, comments.size(), parse.signatures()});
+                     DuplicateIndex::instance().insert(bugId, parse.crashSignatures());
+                     return Analysis{parse.findDuplicate(ourTrace), parse.similarity(ourTrace)};
+                 });
 }
 
-void DuplicateFinderJob::commentsParsed(ParseBugBacktraces::DuplicateRating rating)
+void DuplicateFinderJob::processResults()
 {
-    qCDebug(DRKONQI_LOG) << "Duplicate rating:" << rating;
+    // Evaluate in order, a bug is only looked at once all bugs before it turned out not to be the duplicate.
+    while (!m_pending.isEmpty() && m_pending.constFirst()->rating.has_value()) {
+        Candidate *candidate = m_pending.takeFirst();
+        candidate->deleteLater();
+        const Bugzilla::Bug::Ptr bug = candidate->bug;
+        const ParseBugBacktraces::DuplicateRating rating = *candidate->rating;
 
-    // TODO handle more cases here
-    if (rating != ParseBugBacktraces::PerfectDuplicate) {
-        qCDebug(DRKONQI_LOG) << "Bug" << m_bug->id() << "most likely not a duplicate:" << rating;
-        analyzeNextBug();
-        return;
-    }
+        // TODO handle more cases here
+        if (rating != ParseBugBacktraces::PerfectDuplicate) {
+            // a parent that failed to fetch has no bug
+            qCDebug(DRKONQI_LOG) << "Bug" << (bug ? bug->id() : 0) << "most likely not a duplicate:" << rating;
+            continue;
+        }
 
-    bool unknownStatus = (m_bug->status() == Bugzilla::Bug::Status::Unknown);
-    bool unknownResolution = (m_bug->resolution() == Bugzilla::Bug::Resolution::Unknown);
+        bool unknownStatus = (bug->status() == Bugzilla::Bug::Status::Unknown);
+        bool unknownResolution = (bug->resolution() == Bugzilla::Bug::Resolution::Unknown);
 
-    // The Bug is a duplicate, now find out the status and resolution of the existing report
-    if (m_bug->resolution() == Bugzilla::Bug::Resolution::DUPLICATE) {
-        qCDebug(DRKONQI_LOG) << "Found duplicate is a duplicate itself.";
-        if (!m_result.duplicate) {
-            m_result.duplicate = m_bug->id();
+        // The Bug is a duplicate, now find out the status and resolution of the existing report
+        if (bug->resolution() == Bugzilla::Bug::Resolution::DUPLICATE) {
+            qCDebug(DRKONQI_LOG) << "Found duplicate is a duplicate itself.";
+            if (!m_result.duplicate) {
+                m_result.duplicate = bug->id();
+            }
+            const int parentId = bug->dupe_of();
+            if (parentId <= 0) {
+                qCDebug(DRKONQI_LOG) << "Bug id not valid:" << parentId;
+                continue;
+            }
+            // the parent comes next, before any of the other bugs
+            auto parent = new Candidate(this);
+            m_pending.prepend(parent);
+            qCDebug(DRKONQI_LOG) << "Fetching:" << parentId;
+            parent->job = m_manager->fetchBugReport(parentId, parent);
+            return;
+        } else if (unknownStatus || unknownResolution) {
+            // A resolution is unknown when the bug is unresolved.
+            // Status generally is never unknown.
+            qCDebug(DRKONQI_LOG) << "Either the status or the resolution is unknown.";
+            qCDebug(DRKONQI_LOG) << "Status \"" << bug->status() << "\" known:" << !unknownStatus;
+            qCDebug(DRKONQI_LOG) << "Resolution \"" << bug->resolution() << "\" known:" << !unknownResolution;
+        } else {
+            if (!m_result.duplicate) {
+                m_result.duplicate = bug->id();
+            }
+            m_result.parentDuplicate = bug->id();
+            m_result.status = bug->status();
+            m_result.resolution = bug->resolution();
+            qCDebug(DRKONQI_LOG) << "Found duplicate information (id/status/resolution):" << bug->id() << bug->status() << bug->resolution();
+            finish();
+            return;
         }
-        fetchBug(m_bug->dupe_of());
-    } else if (unknownStatus || unknownResolution) {
-        // A resolution is unknown when the bug is unresolved.
-        // Status generally is never unknown.
-        qCDebug(DRKONQI_LOG) << "Either the status or the resolution is unknown.";
-        qCDebug(DRKONQI_LOG) << "Status \"" << m_bug->status() << "\" known:" << !unknownStatus;
-        qCDebug(DRKONQI_LOG) << "Resolution \"" << m_bug->resolution() << "\" known:" << !unknownResolution;
-        analyzeNextBug();
-    } else {
-        if (!m_result.duplicate) {
-            m_result.duplicate = m_bug->id();
+    }
+
+    fillPipeline();
+}
+
+void DuplicateFinderJob::cancelAfter(Candidate *candidate)
+{
+    const qsizetype index = m_pending.indexOf(candidate);
+    if (index < 0) {
+        return;
+    }
+    m_decided = true;
+    while (m_pending.size() > index + 1) {
+        cancel(m_pending.takeLast());
+    }
+}
+
+void DuplicateFinderJob::cancel(Candidate *candidate)
+{
+    // Not pending anymore, so whatever the request still reports is ignored.
+    qCDebug(DRKONQI_LOG) << "Cancelling:" << (candidate->bug ? candidate->bug->id() : 0);
+    if (candidate->job) {
+        candidate->job->kill();
+    }
+    if (Batch *batch = candidate->batch) {
+        // the request still matters as long as any candidate of the batch is pending
+        batch->candidates.removeOne(candidate);
+        if (batch->candidates.isEmpty()) {
+            m_batches.removeOne(batch);
+            if (batch->job) {
+                batch->job->kill();
+            }
+            batch->deleteLater();
         }
-        m_result.parentDuplicate = m_bug->id();
-        m_result.status = m_bug->status();
-        m_result.resolution = m_bug->resolution();
-        qCDebug(DRKONQI_LOG) << "Found duplicate information (id/status/resolution):" << m_bug->id() << m_bug->status() << m_bug->resolution();
-        emitResult();
     }
+    candidate->deleteLater();
+}
+
+void DuplicateFinderJob::finish()
+{
+    m_bugs.clear();
+    while (!m_pending.isEmpty()) {
+        cancel(m_pending.takeLast());
+    }
+    DuplicateIndex::instance().save();
+    emitResult();
 }
 
 void DuplicateFinderJob::slotError(const QString &message, QObject *owner)
 {
-    if (this != owner) {
+    if (Batch *batch = takeBatch(owner)) {
+        // One bad bug fails the whole request, find out which by asking for each bug on its own.
+        qCDebug(DRKONQI_LOG) << "Error fetching bugs:" << message;
+        for (Candidate *candidate : std::as_const(batch->candidates)) {
+            fetchComments({candidate});
+        }
+        return;
+    }
+
+    Candidate *candidate = candidateFor(owner);
+    if (!candidate) {
         return;
     }
     qCDebug(DRKONQI_LOG) << "Error fetching bug:" << message;
-    analyzeNextBug();
+    // skip the bug
+    candidate->job = nullptr;
+    candidate->rating = ParseBugBacktraces::NoDuplicate;
+    processResults();
 }
 
 #include "moc_duplicatefinderjob.cpp"
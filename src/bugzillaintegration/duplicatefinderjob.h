@@ -10,10 +10,15 @@
 #ifndef DUPLICATE_FINDER_H
 #define DUPLICATE_FINDER_H
 
+#include <QHash>
 #include <QList>
 
 #include <KJob>
 
+#include <functional>
+#include <optional>
+
+#include "bugbacktracecache.h"
 #include "bugzillalib.h"
 #include "parsebugbacktraces.h"
 
@@ -21,6 +26,17 @@
  * Looks if of the current backtrace is a
  * duplicate of any of the specified bug ids.
  * If a duplicate is found result is emitted instantly
+ *
+ * The comments of several bugs are fetched and parsed concurrently,
+ * the results are evaluated in the order of the bugs though, so the
+ * outcome is the same as when looking at one bug after another.
+ *
+ * The comments of the bugs that are looked at together are fetched in a
+ * single request, each bug is parsed as soon as its comments arrived.
+ *
+ * The backtraces parsed out of the comments are cached (see BugBacktraceCache),
+ * bugs that didn't change since are rated without fetching anything. Bugs the
+ * DuplicateIndex knows to have a backtrace like ours are looked at first.
  */
 class DuplicateFinderJob : public KJob
 {
@@ -51,6 +67,10 @@ public:
     };
 
     DuplicateFinderJob(const QList<Bugzilla::Bug::Ptr> &bugs, BugzillaManager *manager, QObject *parent = nullptr);
+    /**
+     * Looks for duplicates of backtrace rather than of the backtrace DrKonqi generated.
+     */
+    DuplicateFinderJob(const StructuredBacktrace &backtrace, const QList<Bugzilla::Bug::Ptr> &bugs, BugzillaManager *manager, QObject *parent = nullptr);
     ~DuplicateFinderJob() override;
 
     void start() override;
@@ -61,23 +81,63 @@ public:
      */
     Result result() const;
 
+Q_SIGNALS:
+    /**
+     * Emitted for every bug whose backtraces were compared to ours
+     * @param similarity of the most similar backtrace of the bug, between 0 and 1
+     * @see ParseBugBacktraces::similarity
+     */
+    void similarityScored(int bugId, double similarity);
+
 private Q_SLOTS:
     void slotBugReportFetched(const Bugzilla::Bug::Ptr &bug, QObject *owner);
     void slotCommentsFetched(const QList<Bugzilla::Comment::Ptr> &comments, QObject *owner);
+    void slotBugCommentsFetched(int bugId, const QList<Bugzilla::Comment::Ptr> &comments, QObject *owner);
+    void slotBugsCommentsFetched(const QHash<int, QList<Bugzilla::Comment::Ptr>> &comments, QObject *owner);
 
     void slotError(const QString &message, QObject *owner);
 
 private:
-    void analyzeNextBug();
-    void fetchBug(int bugId);
-    void commentsParsed(ParseBugBacktraces::DuplicateRating rating);
+    class Candidate;
+    class Batch;
+    struct Analysis {
+        ParseBugBacktraces::DuplicateRating rating = ParseBugBacktraces::NoDuplicate;
+        double similarity = 0;
+    };
+
+    Candidate *candidateFor(QObject *owner) const;
+    Batch *batchFor(QObject *owner) const;
+    // Removes the batch once its request reported back, its candidates are left to the caller.
+    Batch *takeBatch(QObject *owner);
+    void prioritizeIndexedDuplicates();
+    void fillPipeline();
+    // Rates the candidates from the cache, the comments of the others are fetched.
+    void analyze(const QList<Candidate *> &candidates);
+    void fetchComments(const QList<Candidate *> &candidates);
+    void parseComments(Candidate *candidate, const QList<Bugzilla::Comment::Ptr> &comments);
+    // Runs analysis on the thread pool.
+    void analyzeAsync(Candidate *candidate, std::function<Analysis()> analysis);
+    void rate(Candidate *candidate, const Analysis &analysis);
+    void processResults();
+    void cancelAfter(Candidate *candidate);
+    void cancel(Candidate *candidate);
+    void finish();
 
 private:
     BugzillaManager *m_manager = nullptr;
     Result m_result;
+    const BugBacktraceCache m_cache;
 
-    Bugzilla::Bug::Ptr m_bug = nullptr;
+    // set once started unless given to us
+    std::optional<StructuredBacktrace> m_ourTrace;
 
+    // not looked at yet
     QList<Bugzilla::Bug::Ptr> m_bugs;
+    // being fetched, parsed or waiting for the ones before them to be evaluated, in order
+    QList<Candidate *> m_pending;
+    // requests fetching the comments of several pending candidates
+    QList<Batch *> m_batches;
+    // a perfect duplicate was found, the bugs after it don't matter anymore
+    bool m_decided = false;
 };
 #endif
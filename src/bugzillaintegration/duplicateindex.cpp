@@ -0,0 +1,243 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "duplicateindex.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <mutex>
+
+#include "drkonqi_debug.h"
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+constexpr quint32 MAGIC = 0x44524458; // DRDX
+// Bump when the format or the way signatures are computed change, older files are then simply ignored.
+constexpr quint32 VERSION = 1;
+constexpr QDataStream::Version STREAM_VERSION = QDataStream::Qt_6_5;
+
+void addPosting(QHash<quint64, QList<qint64>> &postings, quint64 hash, qint64 bugId)
+{
+    QList<qint64> &bugs = postings[hash];
+    if (!bugs.contains(bugId)) {
+        bugs.append(bugId);
+    }
+}
+
+void removePosting(QHash<quint64, QList<qint64>> &postings, quint64 hash, qint64 bugId)
+{
+    auto it = postings.find(hash);
+    if (it == postings.end()) {
+        return;
+    }
+    it->removeOne(bugId);
+    if (it->isEmpty()) {
+        postings.erase(it);
+    }
+}
+} // namespace
+
+DuplicateIndex::DuplicateIndex(const QString &path)
+    : m_path(path)
+{
+}
+
+DuplicateIndex &DuplicateIndex::instance()
+{
+    static DuplicateIndex index(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/duplicateindex"_L1);
+    static std::once_flag loaded;
+    std::call_once(loaded, [] {
+        index.load();
+    });
+    return index;
+}
+
+void DuplicateIndex::insert(qint64 bugId, const QList<CrashSignature> &signatures)
+{
+    QList<Entry> entries;
+    for (const CrashSignature &signature : signatures) {
+        if (!signature.isEmpty()) {
+            entries.append({signature.hash(), signature.frameHashes()});
+        }
+    }
+
+    const QMutexLocker locker(&m_mutex);
+    remove(bugId);
+    if (entries.isEmpty()) {
+        m_dirty = true;
+        return;
+    }
+    while (m_insertionOrder.size() >= MaxBugs) {
+        remove(m_insertionOrder.constFirst());
+    }
+    m_bugs.insert(bugId, entries);
+    m_insertionOrder.append(bugId);
+    addPostings(bugId, entries);
+    m_dirty = true;
+}
+
+QList<DuplicateIndex::Match> DuplicateIndex::lookup(const CrashSignature &signature) const
+{
+    if (signature.isEmpty()) {
+        return {};
+    }
+
+    const QMutexLocker locker(&m_mutex);
+
+    QHash<qint64, Match> matches;
+    for (const qint64 bugId : m_bySignature.value(signature.hash())) {
+        matches.insert(bugId, Match{bugId, true, signature.frameHashes().size()});
+    }
+
+    // Count in how many of the signature's frames each bug appears, a frame appearing twice in the signature counts twice.
+    QHash<qint64, qsizetype> sharedFrames;
+    for (const quint64 frameHash : signature.frameHashes()) {
+        for (const qint64 bugId : m_byFrame.value(frameHash)) {
+            ++sharedFrames[bugId];
+        }
+    }
+    const qsizetype threshold = std::min(MinSharedFrames, signature.frameHashes().size());
+    for (auto it = sharedFrames.cbegin(); it != sharedFrames.cend(); ++it) {
+        if (it.value() >= threshold && !matches.contains(it.key())) {
+            matches.insert(it.key(), Match{it.key(), false, it.value()});
+        }
+    }
+
+    QList<Match> result = matches.values();
+    std::sort(result.begin(), result.end(), [](const Match &a, const Match &b) {
+        if (a.exact != b.exact) {
+            return a.exact;
+        }
+        if (a.sharedFrames != b.sharedFrames) {
+            return a.sharedFrames > b.sharedFrames;
+        }
+        return a.bugId > b.bugId; // newer bugs first, like the search results
+    });
+    return result;
+}
+
+qsizetype DuplicateIndex::size() const
+{
+    const QMutexLocker locker(&m_mutex);
+    return m_bugs.size();
+}
+
+void DuplicateIndex::addPostings(qint64 bugId, const QList<Entry> &entries)
+{
+    for (const Entry &entry : entries) {
+        addPosting(m_bySignature, entry.hash, bugId);
+        for (const quint64 frameHash : entry.frameHashes) {
+            addPosting(m_byFrame, frameHash, bugId);
+        }
+    }
+}
+
+void DuplicateIndex::remove(qint64 bugId)
+{
+    const QList<Entry> entries = m_bugs.take(bugId);
+    if (entries.isEmpty()) {
+        return;
+    }
+    m_insertionOrder.removeOne(bugId);
+    for (const Entry &entry : entries) {
+        removePosting(m_bySignature, entry.hash, bugId);
+        for (const quint64 frameHash : entry.frameHashes) {
+            removePosting(m_byFrame, frameHash, bugId);
+        }
+    }
+}
+
+void DuplicateIndex::load()
+{
+    const QMutexLocker locker(&m_mutex);
+    m_bugs.clear();
+    m_insertionOrder.clear();
+    m_bySignature.clear();
+    m_byFrame.clear();
+    m_dirty = false;
+
+    QFile file(m_path);
+    if (m_path.isEmpty() || !file.open(QFile::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(STREAM_VERSION);
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if (magic != MAGIC || version != VERSION) {
+        return;
+    }
+
+    // the bugs in insertion order, each with its entries
+    quint32 bugCount = 0;
+    stream >> bugCount;
+    for (quint32 i = 0; i < bugCount && stream.status() == QDataStream::Ok; ++i) {
+        qint64 bugId = 0;
+        quint32 entryCount = 0;
+        stream >> bugId >> entryCount;
+        QList<Entry> entries;
+        for (quint32 j = 0; j < entryCount && stream.status() == QDataStream::Ok; ++j) {
+            Entry entry;
+            stream >> entry.hash >> entry.frameHashes;
+            entries.append(entry);
+        }
+        if (stream.status() == QDataStream::Ok && !entries.isEmpty() && !m_bugs.contains(bugId)) {
+            m_bugs.insert(bugId, entries);
+            m_insertionOrder.append(bugId);
+            addPostings(bugId, entries);
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(DRKONQI_LOG) << "Duplicate index is corrupt, starting over";
+        m_bugs.clear();
+        m_insertionOrder.clear();
+        m_bySignature.clear();
+        m_byFrame.clear();
+    }
+}
+
+bool DuplicateIndex::save()
+{
+    const QMutexLocker locker(&m_mutex);
+    if (!m_dirty || m_path.isEmpty()) {
+        return true;
+    }
+
+    QDir().mkpath(QFileInfo(m_path).path());
+    QSaveFile file(m_path);
+    if (!file.open(QFile::WriteOnly)) {
+        qCWarning(DRKONQI_LOG) << "Failed to write duplicate index" << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(STREAM_VERSION);
+    stream << MAGIC << VERSION << quint32(m_insertionOrder.size());
+    for (const qint64 bugId : std::as_const(m_insertionOrder)) {
+        const QList<Entry> &entries = m_bugs[bugId];
+        stream << bugId << quint32(entries.size());
+        for (const Entry &entry : entries) {
+            stream << entry.hash << entry.frameHashes;
+        }
+    }
+
+    if (!file.commit()) {
+        qCWarning(DRKONQI_LOG) << "Failed to write duplicate index" << file.errorString();
+        return false;
+    }
+    m_dirty = false;
+    return true;
+}
@@ -0,0 +1,90 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+#include "parser/crashsignature.h"
+
+/**
+ * Persistent inverted index from crash signatures (see CrashSignature) to the bugs whose comments
+ * contain a backtrace with that signature, and from the signatures' frame hashes to those bugs.
+ *
+ * Exact duplicates share the signature, near duplicates share at least MinSharedFrames of its frames.
+ * Both are found with a couple of hash lookups, without fetching or comparing any backtrace.
+ *
+ * The index only learns about bugs whose comments were parsed, and a bug's entry is only as
+ * recent as the comments it was built from. It is therefore used to decide which bugs to look
+ * at first, not to rate them.
+ *
+ * All methods may be called from any thread.
+ */
+class DuplicateIndex
+{
+public:
+    struct Match {
+        qint64 bugId = 0;
+        bool exact = false;
+        // the amount of frames of the looked up signature in the backtraces of the bug
+        qsizetype sharedFrames = 0;
+    };
+
+    // 60%, like ParseBugBacktraces::MaybeDuplicate
+    static constexpr qsizetype MinSharedFrames = 3;
+    // Bugs are evicted least recently inserted first beyond this
+    static constexpr qsizetype MaxBugs = 10000;
+
+    /**
+     * @param path of the file the index is kept in, an empty path keeps it in memory only
+     */
+    explicit DuplicateIndex(const QString &path = QString());
+    Q_DISABLE_COPY_MOVE(DuplicateIndex)
+
+    /**
+     * @return the index in the cache location, loaded on first use
+     */
+    static DuplicateIndex &instance();
+
+    /**
+     * Replaces what is known about bugId with the signatures of its backtraces. Empty signatures are skipped.
+     */
+    void insert(qint64 bugId, const QList<CrashSignature> &signatures);
+    /**
+     * @return the exact and near duplicates of signature, exact ones and those sharing more frames first
+     */
+    QList<Match> lookup(const CrashSignature &signature) const;
+    qsizetype size() const;
+
+    /**
+     * Reads the index from its file, replacing the current contents. A missing or unreadable file leaves it empty.
+     */
+    void load();
+    /**
+     * Writes the index to its file if it changed since it was loaded or last saved.
+     */
+    bool save();
+
+private:
+    struct Entry {
+        quint64 hash = 0;
+        QList<quint64> frameHashes;
+    };
+
+    void addPostings(qint64 bugId, const QList<Entry> &entries);
+    void remove(qint64 bugId);
+
+    mutable QMutex m_mutex;
+    const QString m_path;
+    bool m_dirty = false;
+
+    QHash<qint64, QList<Entry>> m_bugs;
+    QList<qint64> m_insertionOrder;
+    QHash<quint64, QList<qint64>> m_bySignature;
+    QHash<quint64, QList<qint64>> m_byFrame;
+};
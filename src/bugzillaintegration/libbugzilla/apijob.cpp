@@ -36,6 +36,11 @@ void APIJob::setAutoStart(bool start)
     m_autostart = start;
 }
 
+void APIJob::setStreamPath(const QStringList &path)
+{
+    Q_UNUSED(path);
+}
+
 void APIJob::connectNotify(const QMetaMethod &signal)
 {
     if (m_autostart && signal == QMetaMethod::fromSignal(&KJob::finished)) {
@@ -45,23 +50,31 @@ void APIJob::connectNotify(const QMetaMethod &signal)
     KJob::connectNotify(signal);
 }
 
-NetworkAPIJob::NetworkAPIJob(const QUrl &url, const std::function<QNetworkReply *(QNetworkAccessManager &, QNetworkRequest &)> &starter, QObject *parent)
+NetworkAPIJob::NetworkAPIJob(const std::shared_ptr<QNetworkAccessManager> &manager,
+                             QNetworkRequest request,
+                             const std::function<QNetworkReply *(QNetworkAccessManager &, QNetworkRequest &)> &starter,
+                             QObject *parent)
     : APIJob(parent)
+    , m_manager(manager)
 {
-    m_manager.setRedirectPolicy(QNetworkRequest::NoLessSafeRedirectPolicy);
-    QNetworkRequest request(url);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json"_qba);
-    request.setRawHeader("Accept"_qba, "application/json"_qba);
-    request.setHeader(QNetworkRequest::UserAgentHeader, "DrKonqi"_qba);
-
-    auto reply = starter(m_manager, request);
+    setCapabilities(KJob::Killable);
+    auto reply = starter(*m_manager, request);
+    m_reply = reply;
 
     connect(reply, &QIODevice::readyRead, this, [this, reply] {
-        m_data += reply->readAll();
+        if (!m_streamReader) {
+            m_data += reply->readAll();
+            return;
+        }
+        const QList<JsonStreamReader::Value> values = m_streamReader->read(reply->readAll());
+        for (const JsonStreamReader::Value &value : values) {
+            Q_EMIT valueRead(value.key, value.value);
+        }
     });
 
     connect(reply, &QNetworkReply::finished, this, [this, reply] {
         reply->deleteLater();
+        qCDebug(BUGZILLA_LOG) << reply->url().path() << "from cache:" << reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool();
 
         // Set errors, they are read by document() when the consumer reads
         // the data and possibly raised as exception.
@@ -87,6 +100,23 @@ NetworkAPIJob::NetworkAPIJob(const QUrl &url, const std::function<QNetworkReply
     });
 }
 
+void NetworkAPIJob::setStreamPath(const QStringList &path)
+{
+    Q_ASSERT(m_data.isEmpty());
+    m_streamReader.emplace(path);
+}
+
+bool NetworkAPIJob::doKill()
+{
+    if (m_reply) {
+        // KJob finishes the job, the reply must not do that (again) when it finishes on abort
+        m_reply->disconnect(this);
+        m_reply->abort();
+        m_reply->deleteLater();
+    }
+    return true;
+}
+
 } // namespace Bugzilla
 
 #include "moc_apijob.cpp"
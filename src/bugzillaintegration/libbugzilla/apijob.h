@@ -11,9 +11,15 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QNetworkAccessManager>
+#include <QPointer>
 
 #include <KJob>
 
+#include <memory>
+#include <optional>
+
+#include "jsonstreamreader.h"
+
 class QNetworkRequest;
 class QNetworkReply;
 
@@ -46,6 +52,19 @@ public:
 
     void setAutoStart(bool start);
 
+    /**
+     * Hands out the values of the container at path (keys from the document
+     * root, see JsonStreamReader) through valueRead() as soon as each of them
+     * is received, they are then left out of document().
+     * Must be set before the response arrives, i.e. right after the job was
+     * created. Jobs that can't stream keep all values in document(), so
+     * consumers have to look there as well.
+     */
+    virtual void setStreamPath(const QStringList &path);
+
+Q_SIGNALS:
+    void valueRead(const QString &key, const QJsonValue &value);
+
 public:
     // Should be protected but since we call it for testing I don't care.
     virtual QByteArray data() const = 0;
@@ -66,19 +85,32 @@ class NetworkAPIJob : public APIJob
 public:
     QByteArray data() const override
     {
-        return m_data;
+        return m_streamReader ? m_streamReader->remainder() : m_data;
     }
 
+    void setStreamPath(const QStringList &path) override;
+
+protected:
+    /**
+     * Aborts the request.
+     */
+    bool doKill() override;
+
 private:
-    explicit NetworkAPIJob(const QUrl &url,
+    explicit NetworkAPIJob(const std::shared_ptr<QNetworkAccessManager> &manager,
+                           QNetworkRequest request,
                            const std::function<QNetworkReply *(QNetworkAccessManager &, QNetworkRequest &)> &starter,
                            QObject *parent = nullptr);
 
     QByteArray m_data;
     QByteArray m_putData;
     QList<QByteArray> m_dataSegments;
+    QPointer<QNetworkReply> m_reply;
+    // set when streaming, it then holds the data instead of m_data
+    std::optional<JsonStreamReader> m_streamReader;
 
-    QNetworkAccessManager m_manager;
+    // shared with the connection and its other jobs
+    std::shared_ptr<QNetworkAccessManager> m_manager;
 };
 
 } // namespace Bugzilla
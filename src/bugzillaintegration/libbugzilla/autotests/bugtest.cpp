@@ -57,6 +57,9 @@ public:
         if (path == "/bug" && query.toString() == "product=dragonplayer2") {
             return new JobDouble{QFINDTESTDATA("data/bugs.unresolved.json")};
         }
+        if (path == "/bug" && query.toString() == "include_fields=id,summary,status,resolution,dupe_of&product=dragonplayer3") {
+            return new JobDouble{QFINDTESTDATA("data/bugs.fields.json")};
+        }
         if (path == "/bug" && query.toString() == "product=dragonplayerSecondProduct&product=dragonplayerFirstProduct") {
             // simply to test the query params. returns regular unresolved result
             return new JobDouble{QFINDTESTDATA("data/bugs.unresolved.json")};
@@ -140,6 +143,7 @@ private Q_SLOTS:
         QCOMPARE(bug->dupe_of(), -1);
         QCOMPARE(bug->is_open(), false);
         QCOMPARE(bug->customField("cf_versionfixedin"), "5.0");
+        QCOMPARE(bug->last_change_time(), QDateTime::fromString("2008-02-13T02:55:08Z", Qt::ISODate));
     }
 
     void testSearchUnresolved()
@@ -168,6 +172,26 @@ private Q_SLOTS:
         // None of the above should fail assertions or exception tests.
     }
 
+    void testSearchIncludeFields()
+    {
+        Bugzilla::BugSearch search;
+        search.products = QStringList{"dragonplayer3"};
+        search.include_fields = QStringList{"id", "summary", "status", "resolution", "dupe_of"};
+        auto job = Bugzilla::BugClient().search(search);
+        job->start();
+        const QList<Bug::Ptr> bugs = Bugzilla::BugClient().search(job);
+        QCOMPARE(bugs.size(), 1);
+        const Bug::Ptr bug = bugs.at(0);
+        QCOMPARE(bug->id(), 156514);
+        QCOMPARE(bug->summary(), "Supported filetypes not shown in Play File.. Dialog");
+        QCOMPARE(bug->status(), Bug::Status::RESOLVED);
+        QCOMPARE(bug->resolution(), Bug::Resolution::DUPLICATE);
+        QCOMPARE(bug->dupe_of(), 156513);
+        // fields that weren't asked for are simply unset
+        QCOMPARE(bug->product(), QString());
+        QVERIFY(!bug->last_change_time().isValid());
+    }
+
     void testNewBug()
     {
         Bugzilla::NewBug bug;
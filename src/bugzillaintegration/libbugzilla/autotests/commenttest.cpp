@@ -27,6 +27,9 @@ public:
         if (path == "/bug/407363/comment" && query.toString().isEmpty()) {
             return new JobDouble{QFINDTESTDATA("data/comments.json")};
         }
+        if (path == "/bug/407363/comment" && query.values("ids") == QStringList{"407364"}) {
+            return new JobDouble{QFINDTESTDATA("data/comments.batch.json")};
+        }
         if (path == "/bug/1/comment" && query.toString().isEmpty()) {
             return new JobDouble{QFINDTESTDATA("data/error.nobug.invalid.json")};
         }
@@ -78,6 +81,23 @@ private Q_SLOTS:
         QCOMPARE(tre->text(), "tre");
     }
 
+    void testBatch()
+    {
+        Bugzilla::CommentClient c;
+        auto job = c.getFromBugs({407363, 407364});
+        job->start();
+        auto comments = c.getFromBugs(job);
+        QCOMPARE(comments.size(), 2);
+
+        QCOMPARE(comments.value(407363).size(), 1);
+        QCOMPARE(comments.value(407363)[0]->text(), "uno");
+
+        const auto zwei = comments.value(407364);
+        QCOMPARE(zwei.size(), 2);
+        QCOMPARE(zwei[1]->bug_id(), 407364);
+        QCOMPARE(zwei[1]->text(), "zwei");
+    }
+
     void testSearchNoBugInvalid()
     {
         // Our bugzilla has a bug where errors do not have error:true!
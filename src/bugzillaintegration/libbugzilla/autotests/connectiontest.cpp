@@ -5,9 +5,12 @@
 */
 
 #include <QDebug>
+#include <QDirIterator>
+#include <QFile>
 #include <QMutex>
 #include <QSignalSpy>
 #include <QTcpServer>
+#include <QTemporaryDir>
 #include <QTest>
 #include <QThread>
 #include <QTimer>
@@ -129,6 +132,135 @@ private Q_SLOTS:
         QVERIFY_EXCEPTION_THROWN(job->document(), Bugzilla::APIException);
     }
 
+    void testConnectionReuse()
+    {
+        qDebug() << Q_FUNC_INFO;
+        // Consecutive requests share the kept alive connection of the first one.
+        QTcpServer t;
+        QCOMPARE(t.listen(QHostAddress::LocalHost, 0), true);
+        int connections = 0;
+        connect(&t, &QTcpServer::newConnection, &t, [&t, &connections]() {
+            ++connections;
+            QTcpSocket *socket = t.nextPendingConnection();
+            connect(socket, &QTcpSocket::readyRead, socket, [socket] { // clazy:exclude=lambda-in-connect
+                socket->readAll();
+                socket->write("HTTP/1.1 200 OK\r\nContent-Length: 7\r\nConnection: keep-alive\r\n\r\nHello!\n");
+            });
+        });
+
+        QUrl root("http://localhost");
+        root.setPort(t.serverPort());
+        HTTPConnection c(root);
+        for (int i = 0; i < 3; ++i) {
+            auto job = c.get("/hi");
+            job->exec();
+            QCOMPARE(job->error(), KJob::NoError);
+            QCOMPARE(job->data(), "Hello!\n");
+        }
+        QCOMPARE(connections, 1);
+    }
+
+    void testMetadataCache()
+    {
+        qDebug() << Q_FUNC_INFO;
+        // Metadata is revalidated with its ETag or Last-Modified and served from the cache on 304, even when the
+        // response claims to be fresh for a while. Other requests aren't cached.
+        QTcpServer t;
+        QCOMPARE(t.listen(QHostAddress::LocalHost, 0), true);
+        QStringList requests;
+        QStringList revalidations;
+        connect(&t, &QTcpServer::newConnection, &t, [&t, &requests, &revalidations]() {
+            QTcpSocket *socket = t.nextPendingConnection();
+            connect(socket, &QTcpSocket::readyRead, socket, [socket, &requests, &revalidations] { // clazy:exclude=lambda-in-connect
+                const QString httpBlob = QString::fromUtf8(socket->readAll());
+                const QString requestLine = httpBlob.section(QLatin1Char('\n'), 0, 0).trimmed();
+                requests << requestLine;
+                if (httpBlob.contains(QLatin1String("If-None-Match: \"v1\""), Qt::CaseInsensitive)
+                    || httpBlob.contains(QLatin1String("If-Modified-Since: Wed, 01 Jan 2020 00:00:00 GMT"), Qt::CaseInsensitive)) {
+                    revalidations << requestLine;
+                    socket->write("HTTP/1.1 304 Not Modified\r\nETag: \"v1\"\r\nContent-Length: 0\r\n\r\n");
+                    return;
+                }
+                if (requestLine.startsWith(QLatin1String("GET /version"))) {
+                    socket->write(
+                        "HTTP/1.1 200 OK\r\nLast-Modified: Wed, 01 Jan 2020 00:00:00 GMT\r\nCache-Control: max-age=3600\r\n"
+                        "Content-Type: application/json\r\nContent-Length: 8\r\n\r\n{\"a\":1}\n");
+                    return;
+                }
+                socket->write("HTTP/1.1 200 OK\r\nETag: \"v1\"\r\nContent-Type: application/json\r\nContent-Length: 8\r\n\r\n{\"a\":1}\n");
+            });
+        });
+
+        QTemporaryDir cacheDir;
+        QVERIFY(cacheDir.isValid());
+        QUrl root("http://localhost");
+        root.setPort(t.serverPort());
+        HTTPConnection c(root);
+        c.setCacheDirectory(cacheDir.path());
+        for (const QString &path : {QStringLiteral("/product/dragonplayer"),
+                                    QStringLiteral("/product/dragonplayer"),
+                                    QStringLiteral("/version"),
+                                    QStringLiteral("/version"),
+                                    QStringLiteral("/bug")}) {
+            auto job = c.get(path);
+            job->exec();
+            QCOMPARE(job->error(), KJob::NoError);
+            QCOMPARE(job->data(), "{\"a\":1}\n");
+        }
+        c.get("/bug")->exec();
+
+        // the second metadata requests reached the server and were answered from the cache, the bug requests never were
+        QCOMPARE(requests.size(), 6);
+        QCOMPARE(revalidations.size(), 2);
+        QVERIFY(revalidations.at(0).startsWith(QLatin1String("GET /product/dragonplayer")));
+        QVERIFY(revalidations.at(1).startsWith(QLatin1String("GET /version")));
+        QCOMPARE(requests.count(QStringLiteral("GET /bug HTTP/1.1")), 2);
+    }
+
+    void testMetadataCacheWithToken()
+    {
+        qDebug() << Q_FUNC_INFO;
+        // The token is sent in the query, requests carrying it are never written to the cache.
+        QTcpServer t;
+        QCOMPARE(t.listen(QHostAddress::LocalHost, 0), true);
+        QStringList requests;
+        connect(&t, &QTcpServer::newConnection, &t, [&t, &requests]() {
+            QTcpSocket *socket = t.nextPendingConnection();
+            connect(socket, &QTcpSocket::readyRead, socket, [socket, &requests] { // clazy:exclude=lambda-in-connect
+                const QString httpBlob = QString::fromUtf8(socket->readAll());
+                requests << httpBlob.section(QLatin1Char('\n'), 0, 0).trimmed();
+                if (httpBlob.contains(QLatin1String("If-None-Match: \"v1\""), Qt::CaseInsensitive)) {
+                    socket->write("HTTP/1.1 304 Not Modified\r\nETag: \"v1\"\r\nContent-Length: 0\r\n\r\n");
+                    return;
+                }
+                socket->write("HTTP/1.1 200 OK\r\nETag: \"v1\"\r\nContent-Type: application/json\r\nContent-Length: 8\r\n\r\n{\"a\":1}\n");
+            });
+        });
+
+        QTemporaryDir cacheDir;
+        QVERIFY(cacheDir.isValid());
+        QUrl root("http://localhost");
+        root.setPort(t.serverPort());
+        HTTPConnection c(root);
+        c.setCacheDirectory(cacheDir.path());
+        c.setToken(QStringLiteral("secret-token"));
+        for (int i = 0; i < 2; ++i) {
+            auto job = c.get(QStringLiteral("/product/dragonplayer"));
+            job->exec();
+            QCOMPARE(job->error(), KJob::NoError);
+            QCOMPARE(job->data(), "{\"a\":1}\n");
+        }
+
+        QCOMPARE(requests.size(), 2);
+        QVERIFY(requests.at(1).contains(QLatin1String("token=secret-token")));
+        QDirIterator it(cacheDir.path(), QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            QFile file(it.next());
+            QVERIFY(file.open(QIODevice::ReadOnly));
+            QVERIFY2(!file.readAll().contains("secret-token"), qPrintable(file.fileName()));
+        }
+    }
+
     void testPut()
     {
         qDebug() << Q_FUNC_INFO;
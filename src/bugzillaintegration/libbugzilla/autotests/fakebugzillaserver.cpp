@@ -0,0 +1,254 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "fakebugzillaserver.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include <algorithm>
+#include <memory>
+
+namespace Bugzilla
+{
+namespace
+{
+constexpr std::chrono::milliseconds BANDWIDTH_INTERVAL{50};
+
+QByteArray reasonPhrase(int status)
+{
+    switch (status) {
+    case 200:
+        return QByteArrayLiteral("OK");
+    case 400:
+        return QByteArrayLiteral("Bad Request");
+    case 404:
+        return QByteArrayLiteral("Not Found");
+    case 500:
+        return QByteArrayLiteral("Internal Server Error");
+    case 503:
+        return QByteArrayLiteral("Service Unavailable");
+    }
+    return QByteArrayLiteral("Unknown");
+}
+
+QString routeKey(const QByteArray &method, const QString &path)
+{
+    return QString::fromLatin1(method) + QLatin1Char(' ') + path;
+}
+} // namespace
+
+FakeBugzillaServer::FakeBugzillaServer(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_server, &QTcpServer::newConnection, this, [this] {
+        while (QTcpSocket *socket = m_server.nextPendingConnection()) {
+            connect(socket, &QTcpSocket::readyRead, this, [this, socket] {
+                readRequests(socket);
+            });
+            connect(socket, &QTcpSocket::disconnected, this, [this, socket] {
+                m_buffers.remove(socket);
+                socket->deleteLater();
+            });
+        }
+    });
+}
+
+bool FakeBugzillaServer::listen()
+{
+    return m_server.listen(QHostAddress::LocalHost, 0);
+}
+
+QUrl FakeBugzillaServer::root() const
+{
+    QUrl root(QStringLiteral("http://127.0.0.1/rest"));
+    root.setPort(m_server.serverPort());
+    return root;
+}
+
+void FakeBugzillaServer::route(const QByteArray &method, const QString &path, const Handler &handler)
+{
+    m_routes.insert(routeKey(method, path), handler);
+}
+
+void FakeBugzillaServer::route(const QByteArray &method, const QString &path, const QString &fixture)
+{
+    QFile file(fixture);
+    if (!file.open(QFile::ReadOnly)) {
+        qWarning() << "Failed to read fixture" << fixture;
+    }
+    const QByteArray body = file.readAll();
+    route(method, path, [body](const Request &) {
+        return Response{200, body};
+    });
+}
+
+void FakeBugzillaServer::setLatency(std::chrono::milliseconds latency)
+{
+    m_latency = latency;
+}
+
+void FakeBugzillaServer::setBandwidth(qint64 bytesPerSecond)
+{
+    m_bytesPerSecond = bytesPerSecond;
+}
+
+void FakeBugzillaServer::setFailEvery(int nth, int status)
+{
+    m_failEvery = nth;
+    m_failStatus = status;
+}
+
+QList<FakeBugzillaServer::Request> FakeBugzillaServer::requests() const
+{
+    return m_requests;
+}
+
+FakeBugzillaServer::Response FakeBugzillaServer::apiError(int code, const QString &message)
+{
+    // Like the recorded errors of bugs.kde.org: a successful response that doesn't reliably set error:true.
+    const QJsonObject error{
+        {QStringLiteral("code"), code},
+        {QStringLiteral("documentation"), QStringLiteral("https://bugzilla.readthedocs.org/en/5.0/api/")},
+        {QStringLiteral("error"), QJsonValue::Null},
+        {QStringLiteral("message"), message},
+    };
+    return Response{200, QJsonDocument(error).toJson(QJsonDocument::Compact)};
+}
+
+QByteArray FakeBugzillaServer::commentsPayload(const QList<int> &bugIds, int commentsPerBug, qsizetype commentSize)
+{
+    // Frames of a backtrace, repeated until the comment has its size.
+    QByteArray text = QByteArrayLiteral("Application: test (1.0)\n\nThread 1 (Thread 0x7f (LWP 1)):\n[KCrash Handler]\n");
+    for (int frame = 4; text.size() < commentSize; ++frame) {
+        text += QStringLiteral("#%1  0x00007f0000%2 in Frame%3::function (this=0x0) at file%3.cpp:%1\n")
+                    .arg(frame)
+                    .arg(frame, 6, 16, QLatin1Char('0'))
+                    .arg(frame % 17)
+                    .toUtf8();
+    }
+    text.truncate(commentSize);
+    const QString comment = QString::fromUtf8(text);
+
+    QJsonObject bugs;
+    int commentId = 1;
+    for (int bugId : bugIds) {
+        QJsonArray comments;
+        for (int i = 0; i < commentsPerBug; ++i) {
+            comments.append(QJsonObject{
+                {QStringLiteral("bug_id"), bugId},
+                {QStringLiteral("count"), i},
+                {QStringLiteral("creator"), QStringLiteral("tester@kde.org")},
+                {QStringLiteral("id"), commentId++},
+                {QStringLiteral("text"), comment},
+            });
+        }
+        bugs.insert(QString::number(bugId), QJsonObject{{QStringLiteral("comments"), comments}});
+    }
+    return QJsonDocument(QJsonObject{{QStringLiteral("bugs"), bugs}, {QStringLiteral("comments"), QJsonObject()}}).toJson(QJsonDocument::Compact);
+}
+
+void FakeBugzillaServer::readRequests(QTcpSocket *socket)
+{
+    QByteArray &buffer = m_buffers[socket];
+    buffer += socket->readAll();
+
+    // More than one request may have arrived, or only part of one.
+    while (true) {
+        const qsizetype headerEnd = buffer.indexOf("\r\n\r\n");
+        if (headerEnd < 0) {
+            return;
+        }
+        const QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+        qsizetype contentLength = 0;
+        for (const QByteArray &line : lines) {
+            const qsizetype colon = line.indexOf(':');
+            if (colon > 0 && line.left(colon).trimmed().compare("Content-Length", Qt::CaseInsensitive) == 0) {
+                contentLength = line.mid(colon + 1).trimmed().toLongLong();
+            }
+        }
+        const qsizetype bodyStart = headerEnd + 4;
+        if (buffer.size() < bodyStart + contentLength) {
+            return;
+        }
+
+        // e.g. GET /rest/bug?id=1 HTTP/1.1
+        const QList<QByteArray> requestLine = lines.constFirst().trimmed().split(' ');
+        const QUrl url(QString::fromUtf8(requestLine.value(1)));
+        Request request;
+        request.method = requestLine.value(0);
+        request.path = url.path();
+        if (request.path.startsWith(QLatin1String("/rest"))) {
+            request.path.remove(0, qsizetype(5));
+        }
+        request.query = QUrlQuery(url);
+        request.body = buffer.mid(bodyStart, contentLength);
+        buffer.remove(0, bodyStart + contentLength);
+
+        m_requests.append(request);
+        const Response response = respond(request);
+
+        QByteArray data = "HTTP/1.1 " + QByteArray::number(response.status) + ' ' + reasonPhrase(response.status) + "\r\n";
+        data += "Content-Type: application/json\r\n";
+        data += "Content-Length: " + QByteArray::number(response.body.size()) + "\r\n";
+        data += "Connection: keep-alive\r\n\r\n";
+        data += response.body;
+
+        if (m_latency.count() > 0) {
+            QTimer::singleShot(m_latency, socket, [this, socket, data] {
+                send(socket, data);
+            });
+        } else {
+            send(socket, data);
+        }
+    }
+}
+
+FakeBugzillaServer::Response FakeBugzillaServer::respond(const Request &request)
+{
+    if (m_failEvery > 0 && m_requests.size() % m_failEvery == 0) {
+        return Response{m_failStatus, {}};
+    }
+
+    const auto it = m_routes.constFind(routeKey(request.method, request.path));
+    if (it == m_routes.constEnd()) {
+        qWarning() << "Unrouted request" << request.method << request.path << request.query.toString();
+        return apiError(32000, QStringLiteral("Unrouted request %1").arg(request.path));
+    }
+    return (*it)(request);
+}
+
+void FakeBugzillaServer::send(QTcpSocket *socket, const QByteArray &data)
+{
+    if (m_bytesPerSecond <= 0) {
+        socket->write(data);
+        return;
+    }
+
+    // Trickles out a slice every interval, like a slow link would.
+    const qsizetype slice = std::max<qint64>(1, m_bytesPerSecond * BANDWIDTH_INTERVAL.count() / 1000);
+    auto remaining = std::make_shared<QByteArray>(data);
+    auto timer = new QTimer(socket);
+    timer->setInterval(BANDWIDTH_INTERVAL);
+    connect(timer, &QTimer::timeout, socket, [socket, timer, remaining, slice] {
+        socket->write(remaining->left(slice));
+        remaining->remove(0, slice);
+        if (remaining->isEmpty()) {
+            timer->stop();
+            timer->deleteLater();
+        }
+    });
+    timer->start();
+}
+
+} // namespace Bugzilla
+
+#include "moc_fakebugzillaserver.cpp"
@@ -0,0 +1,97 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QTcpServer>
+#include <QUrl>
+#include <QUrlQuery>
+
+#include <chrono>
+#include <functional>
+
+class QTcpSocket;
+
+namespace Bugzilla
+{
+/**
+ * A stand-in for a Bugzilla REST server on localhost, for tests and
+ * benchmarks that want to go through the actual HTTPConnection.
+ *
+ * Requests are answered by routes, e.g. replaying recorded fixtures, unrouted
+ * requests get a Bugzilla error. Connections are kept alive like a real
+ * server would. The network can be made worse on purpose: a latency before
+ * every response, a bandwidth limit responses trickle out with and failing
+ * requests with HTTP errors.
+ *
+ * Runs on the thread it lives on, the test must spin an event loop while
+ * waiting for jobs (e.g. KJob::exec()).
+ */
+class FakeBugzillaServer : public QObject
+{
+    Q_OBJECT
+public:
+    struct Request {
+        QByteArray method;
+        QString path; // without the /rest prefix, like Connection's paths
+        QUrlQuery query;
+        QByteArray body;
+    };
+
+    struct Response {
+        int status = 200;
+        QByteArray body;
+    };
+
+    using Handler = std::function<Response(const Request &request)>;
+
+    explicit FakeBugzillaServer(QObject *parent = nullptr);
+
+    bool listen();
+    // To construct an HTTPConnection with.
+    QUrl root() const;
+
+    void route(const QByteArray &method, const QString &path, const Handler &handler);
+    // Replays the fixture file for every request of method on path.
+    void route(const QByteArray &method, const QString &path, const QString &fixture);
+
+    // Delays every response by latency.
+    void setLatency(std::chrono::milliseconds latency);
+    // Limits the throughput of every response, 0 means unlimited.
+    void setBandwidth(qint64 bytesPerSecond);
+    // Answers every nth request with status instead of routing it, 0 disables.
+    void setFailEvery(int nth, int status = 503);
+
+    // All requests received so far, in order.
+    QList<Request> requests() const;
+
+    // A Bugzilla API error as returned for e.g. missing bugs.
+    static Response apiError(int code, const QString &message);
+    // The answer to a batched comment request with commentsPerBug comments of
+    // commentSize bytes (backtrace-like text) for every bug.
+    static QByteArray commentsPayload(const QList<int> &bugIds, int commentsPerBug, qsizetype commentSize);
+
+private:
+    void readRequests(QTcpSocket *socket);
+    Response respond(const Request &request);
+    void send(QTcpSocket *socket, const QByteArray &data);
+
+    QTcpServer m_server;
+    QHash<QString, Handler> m_routes; // by "METHOD path"
+    QHash<QTcpSocket *, QByteArray> m_buffers;
+    QList<Request> m_requests;
+
+    std::chrono::milliseconds m_latency{0};
+    qint64 m_bytesPerSecond = 0;
+    int m_failEvery = 0;
+    int m_failStatus = 503;
+};
+
+} // namespace Bugzilla
@@ -0,0 +1,208 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QElapsedTimer>
+#include <QTest>
+
+#include "../clients/attachmentclient.h"
+#include "../clients/bugclient.h"
+#include "../clients/commentclient.h"
+
+#include "fakebugzillaserver.h"
+
+using namespace std::chrono_literals;
+
+namespace Bugzilla
+{
+// Goes through HTTPConnection against FakeBugzillaServer, the benchmarks include the whole network stack.
+class FakeBugzillaServerTest : public QObject
+{
+    Q_OBJECT
+private:
+    static void setupRoutes(FakeBugzillaServer &server)
+    {
+        server.route("GET", QStringLiteral("/bug"), QFINDTESTDATA("data/bugs.dragonplayer.json"));
+        server.route("POST", QStringLiteral("/bug/1/attachment"), QFINDTESTDATA("data/attachment.new.json"));
+        server.route("GET", QStringLiteral("/bug/1/comment"), [](const FakeBugzillaServer::Request &request) {
+            QList<int> bugIds{1};
+            const QStringList ids = request.query.allQueryItemValues(QStringLiteral("ids"));
+            for (const QString &id : ids) {
+                bugIds.append(id.toInt());
+            }
+            return FakeBugzillaServer::Response{200, FakeBugzillaServer::commentsPayload(bugIds, 10, 64 * 1024)};
+        });
+    }
+
+    static QList<Bug::Ptr> search(const HTTPConnection &connection)
+    {
+        BugClient client(connection);
+        BugSearch search;
+        search.products = QStringList{QStringLiteral("dragonplayer")};
+        KJob *job = client.search(search);
+        job->exec();
+        return client.search(job);
+    }
+
+private Q_SLOTS:
+    void testSearch()
+    {
+        FakeBugzillaServer server;
+        QVERIFY(server.listen());
+        setupRoutes(server);
+        HTTPConnection connection(server.root());
+
+        QCOMPARE(search(connection).size(), 2);
+        QCOMPARE(server.requests().size(), 1);
+        QCOMPARE(server.requests().constFirst().query.queryItemValue(QStringLiteral("product")), QStringLiteral("dragonplayer"));
+    }
+
+    void testUnrouted()
+    {
+        FakeBugzillaServer server;
+        QVERIFY(server.listen());
+        HTTPConnection connection(server.root());
+
+        CommentClient client(connection);
+        KJob *job = client.getFromBug(1);
+        job->exec();
+        QVERIFY_EXCEPTION_THROWN(client.getFromBug(job), Bugzilla::APIException);
+    }
+
+    void testFailures()
+    {
+        FakeBugzillaServer server;
+        QVERIFY(server.listen());
+        setupRoutes(server);
+        server.setFailEvery(2);
+        HTTPConnection connection(server.root());
+
+        QCOMPARE(search(connection).size(), 2);
+        QVERIFY_EXCEPTION_THROWN(search(connection), Bugzilla::ProtocolException);
+        QCOMPARE(search(connection).size(), 2);
+    }
+
+    void testLatency()
+    {
+        FakeBugzillaServer server;
+        QVERIFY(server.listen());
+        setupRoutes(server);
+        server.setLatency(200ms);
+        HTTPConnection connection(server.root());
+
+        QElapsedTimer timer;
+        timer.start();
+        QCOMPARE(search(connection).size(), 2);
+        QVERIFY(timer.elapsed() >= 200);
+    }
+
+    void testBandwidth()
+    {
+        // ~2 MiB of comments at 4 MiB/s, the bugs are streamed as they trickle in
+        FakeBugzillaServer server;
+        QVERIFY(server.listen());
+        setupRoutes(server);
+        server.setBandwidth(4 * 1024 * 1024);
+        HTTPConnection connection(server.root());
+
+        QElapsedTimer timer;
+        timer.start();
+        CommentClient client(connection);
+        KJob *job = client.getFromBugs({1, 2, 3});
+        QList<int> streamed;
+        connect(qobject_cast<APIJob *>(job), &APIJob::valueRead, this, [&streamed](const QString &key) {
+            streamed.append(key.toInt());
+        });
+        job->exec();
+        QVERIFY(timer.elapsed() >= 400);
+        QCOMPARE(streamed, QList<int>({1, 2, 3}));
+        QVERIFY(client.getFromBugs(job).isEmpty());
+    }
+
+    void benchmarkSearch_data()
+    {
+        QTest::addColumn<int>("latency");
+
+        QTest::newRow("localhost") << 0;
+        QTest::newRow("50ms") << 50;
+    }
+
+    void benchmarkSearch()
+    {
+        QFETCH(int, latency);
+        FakeBugzillaServer server;
+        QVERIFY(server.listen());
+        setupRoutes(server);
+        server.setLatency(std::chrono::milliseconds(latency));
+        HTTPConnection connection(server.root());
+
+        QBENCHMARK {
+            QCOMPARE(search(connection).size(), 2);
+        }
+    }
+
+    void benchmarkComments_data()
+    {
+        QTest::addColumn<int>("bugs");
+
+        QTest::newRow("1 bug") << 1;
+        QTest::newRow("8 bugs") << 8;
+    }
+
+    void benchmarkComments()
+    {
+        // 10 comments of 64 KiB per bug, like bugs with a bunch of backtraces
+        QFETCH(int, bugs);
+        FakeBugzillaServer server;
+        QVERIFY(server.listen());
+        setupRoutes(server);
+        server.setLatency(20ms);
+        HTTPConnection connection(server.root());
+
+        QList<int> bugIds;
+        for (int i = 1; i <= bugs; ++i) {
+            bugIds.append(i);
+        }
+        QBENCHMARK {
+            CommentClient client(connection);
+            KJob *job = client.getFromBugs(bugIds);
+            qsizetype comments = 0;
+            connect(qobject_cast<APIJob *>(job), &APIJob::valueRead, this, [&comments](const QString &, const QJsonValue &value) {
+                comments += CommentClient::commentsOf(value.toObject()).size();
+            });
+            job->exec();
+            QCOMPARE(comments, qsizetype(bugs) * 10);
+        }
+    }
+
+    void benchmarkAttachment()
+    {
+        // a 1 MiB backtrace, the upload itself is only limited by localhost
+        FakeBugzillaServer server;
+        QVERIFY(server.listen());
+        setupRoutes(server);
+        server.setLatency(20ms);
+        HTTPConnection connection(server.root());
+
+        NewAttachment attachment;
+        attachment.data = QString(1024 * 1024, QLatin1Char('x'));
+        attachment.file_name = QStringLiteral("backtrace.txt");
+        attachment.summary = QStringLiteral("New crash information added by DrKonqi");
+        attachment.content_type = QStringLiteral("text/plain");
+        QBENCHMARK {
+            AttachmentClient client(connection);
+            KJob *job = client.createAttachment(1, attachment);
+            job->exec();
+            QCOMPARE(client.createAttachment(job).size(), 1);
+        }
+        QVERIFY(server.requests().constLast().body.size() > 1024 * 1024);
+    }
+};
+
+} // namespace Bugzilla
+
+QTEST_GUILESS_MAIN(Bugzilla::FakeBugzillaServerTest)
+
+#include "fakebugzillaservertest.moc"
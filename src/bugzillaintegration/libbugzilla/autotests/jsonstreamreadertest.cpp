@@ -0,0 +1,103 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTest>
+
+#include "../jsonstreamreader.h"
+
+namespace Bugzilla
+{
+class JsonStreamReaderTest : public QObject
+{
+    Q_OBJECT
+private:
+    static QByteArray fixture(const QString &name)
+    {
+        QFile file(QFINDTESTDATA(name));
+        if (!file.open(QFile::ReadOnly)) {
+            return {};
+        }
+        return file.readAll();
+    }
+
+    // Reads data in chunks of chunkSize bytes, as the network would hand them out.
+    static QList<JsonStreamReader::Value> readChunked(JsonStreamReader &reader, const QByteArray &data, qsizetype chunkSize)
+    {
+        QList<JsonStreamReader::Value> values;
+        for (qsizetype i = 0; i < data.size(); i += chunkSize) {
+            values += reader.read(QByteArrayView(data).sliced(i, std::min(chunkSize, data.size() - i)));
+        }
+        return values;
+    }
+
+private Q_SLOTS:
+    void testBugs_data()
+    {
+        QTest::addColumn<qsizetype>("chunkSize");
+
+        QTest::newRow("byte") << qsizetype(1);
+        QTest::newRow("odd") << qsizetype(7);
+        QTest::newRow("whole") << qsizetype(1 << 20);
+    }
+
+    void testBugs()
+    {
+        // the bugs of a comment request, keyed by id
+        QFETCH(qsizetype, chunkSize);
+        const QByteArray data = fixture(QStringLiteral("data/comments.batch.json"));
+        QVERIFY(!data.isEmpty());
+
+        JsonStreamReader reader({QStringLiteral("bugs")});
+        const QList<JsonStreamReader::Value> values = readChunked(reader, data, chunkSize);
+        QCOMPARE(values.size(), 2);
+        QCOMPARE(values.at(0).key, QStringLiteral("407363"));
+        QCOMPARE(values.at(1).key, QStringLiteral("407364"));
+
+        const QJsonObject expected = QJsonDocument::fromJson(data).object().value(QStringLiteral("bugs")).toObject();
+        QVERIFY(values.at(0).value == expected.value(QStringLiteral("407363")));
+        QVERIFY(values.at(1).value == expected.value(QStringLiteral("407364")));
+
+        // everything else is still there
+        QJsonParseError error;
+        const QJsonDocument remainder = QJsonDocument::fromJson(reader.remainder(), &error);
+        QCOMPARE(error.error, QJsonParseError::NoError);
+        QVERIFY(remainder.object().value(QStringLiteral("bugs")).toObject().isEmpty());
+        QVERIFY(remainder.object().contains(QStringLiteral("comments")));
+    }
+
+    void testArrayElements()
+    {
+        // the comments of every bug, the strings contain what would otherwise be structure
+        const QByteArray data = R"({"bugs":{"1":{"comments":[{"text":"a]}\"{,"},{"text":"b"}]},"2":{"comments":[]}}})";
+        JsonStreamReader reader({QStringLiteral("bugs"), QStringLiteral("*"), QStringLiteral("comments")});
+        const QList<JsonStreamReader::Value> values = readChunked(reader, data, 3);
+        QCOMPARE(values.size(), 2);
+        QCOMPARE(values.at(0).key, QString());
+        QCOMPARE(values.at(0).value.toObject().value(QStringLiteral("text")).toString(), QStringLiteral("a]}\"{,"));
+        QCOMPARE(values.at(1).value.toObject().value(QStringLiteral("text")).toString(), QStringLiteral("b"));
+        QCOMPARE(QJsonDocument::fromJson(reader.remainder()).toJson(QJsonDocument::Compact),
+                 QByteArray(R"({"bugs":{"1":{"comments":[]},"2":{"comments":[]}}})"));
+    }
+
+    void testError()
+    {
+        // errors have no bugs, they are entirely left to the consumer
+        const QByteArray data = fixture(QStringLiteral("data/error.nobug.invalid.json"));
+        JsonStreamReader reader({QStringLiteral("bugs")});
+        QVERIFY(readChunked(reader, data, 5).isEmpty());
+        QCOMPARE(reader.remainder(), data);
+    }
+};
+
+} // namespace Bugzilla
+
+QTEST_GUILESS_MAIN(Bugzilla::JsonStreamReaderTest)
+
+#include "jsonstreamreadertest.moc"
@@ -23,6 +23,11 @@ Query BugSearch::toQuery() const
     }
     seen << QStringLiteral("order");
 
+    if (!include_fields.isEmpty()) {
+        query.addQueryItem(QStringLiteral("include_fields"), include_fields.join(QLatin1Char(',')));
+    }
+    seen << QStringLiteral("include_fields");
+
     expandQuery(query, seen);
 
     return query;
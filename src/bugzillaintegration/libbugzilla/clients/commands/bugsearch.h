@@ -22,6 +22,9 @@ class BugSearch : public QueryCommand
     BUGZILLA_MEMBER_PROPERTY(qint64, offset) = -1;
     BUGZILLA_MEMBER_PROPERTY(QString, longdesc);
     BUGZILLA_MEMBER_PROPERTY(QStringList, order);
+    // Only these fields of the bugs are returned, all of them when empty.
+    // Shrinks the response considerably when only a few fields are used.
+    BUGZILLA_MEMBER_PROPERTY(QStringList, include_fields);
 
 public:
     virtual Query toQuery() const override;
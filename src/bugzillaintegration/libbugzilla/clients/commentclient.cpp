@@ -10,6 +10,18 @@
 
 namespace Bugzilla
 {
+QList<Comment::Ptr> CommentClient::commentsOf(const QJsonObject &bug)
+{
+    const QJsonArray comments = bug.value(QStringLiteral("comments")).toArray();
+
+    QList<Comment::Ptr> list;
+    list.reserve(comments.size());
+    for (auto it = comments.constBegin(); it != comments.constEnd(); ++it) {
+        list.append(new Comment((*it).toObject().toVariantHash()));
+    }
+    return list;
+}
+
 QList<Comment::Ptr> CommentClient::getFromBug(KJob *kjob) const
 {
     auto *job = qobject_cast<APIJob *>(kjob);
@@ -18,15 +30,7 @@ QList<Comment::Ptr> CommentClient::getFromBug(KJob *kjob) const
     // The API should never return anything other than the single bug we asked for.
     Q_ASSERT(bugs.keys().size() == 1);
 
-    QJsonObject bug = bugs.value(bugs.keys().at(0)).toObject();
-    QJsonArray comments = bug.value(QStringLiteral("comments")).toArray();
-
-    QList<Comment::Ptr> list;
-    for (auto it = comments.constBegin(); it != comments.constEnd(); ++it) {
-        list.append(new Comment((*it).toObject().toVariantHash()));
-    }
-
-    return list;
+    return commentsOf(bugs.value(bugs.keys().at(0)).toObject());
 }
 
 KJob *CommentClient::getFromBug(int bugId)
@@ -34,4 +38,33 @@ KJob *CommentClient::getFromBug(int bugId)
     return m_connection.get(QStringLiteral("/bug/%1/comment").arg(QString::number(bugId)));
 }
 
+QHash<int, QList<Comment::Ptr>> CommentClient::getFromBugs(KJob *kjob) const
+{
+    auto *job = qobject_cast<APIJob *>(kjob);
+    const QJsonObject bugs = job->object().value(QStringLiteral("bugs")).toObject();
+
+    QHash<int, QList<Comment::Ptr>> hash;
+    hash.reserve(bugs.size());
+    for (auto it = bugs.constBegin(); it != bugs.constEnd(); ++it) {
+        hash.insert(it.key().toInt(), commentsOf(it.value().toObject()));
+    }
+    return hash;
+}
+
+KJob *CommentClient::getFromBugs(const QList<int> &bugIds)
+{
+    Q_ASSERT(!bugIds.isEmpty());
+
+    // Bug.comments answers for the bug in the path and all additional ids.
+    // Servers that only answer for the path omit the others from the result,
+    // callers must expect bugs to be missing.
+    Query query;
+    for (auto it = std::next(bugIds.cbegin()); it != bugIds.cend(); ++it) {
+        query.addQueryItem(QStringLiteral("ids"), QString::number(*it));
+    }
+    APIJob *job = m_connection.get(QStringLiteral("/bug/%1/comment").arg(QString::number(bugIds.constFirst())), query);
+    job->setStreamPath({QStringLiteral("bugs")});
+    return job;
+}
+
 } // namespace Bugzilla
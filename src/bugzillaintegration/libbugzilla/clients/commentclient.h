@@ -7,6 +7,8 @@
 #ifndef COMMENTCLIENT_H
 #define COMMENTCLIENT_H
 
+#include <QHash>
+
 #include "clientbase.h"
 #include "models/comment.h"
 
@@ -19,6 +21,17 @@ public:
 
     QList<Comment::Ptr> getFromBug(KJob *kjob) const;
     KJob *getFromBug(int bugId);
+
+    // Fetches the comments of several bugs in a single request. The result
+    // maps bug ids to their comments, bugs the server didn't answer for are
+    // missing from it.
+    // Each bug is streamed as soon as it is received (see APIJob::valueRead,
+    // the key is the bug id and commentsOf() reads the value), the result
+    // only holds the bugs that weren't streamed.
+    QHash<int, QList<Comment::Ptr>> getFromBugs(KJob *kjob) const;
+    KJob *getFromBugs(const QList<int> &bugIds);
+
+    static QList<Comment::Ptr> commentsOf(const QJsonObject &bug);
 };
 
 } // namespace Bugzilla
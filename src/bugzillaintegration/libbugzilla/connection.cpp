@@ -6,13 +6,53 @@
 
 #include "connection.h"
 
+#include <QDateTime>
 #include <QNetworkAccessManager>
+#include <QNetworkDiskCache>
+#include <QTimeZone>
 #include <QUrlQuery>
 
 #include "bugzilla_debug.h"
 
 namespace Bugzilla
 {
+namespace
+{
+constexpr qint64 MAX_CACHE_SIZE = 8 * 1024 * 1024;
+
+// Requests for data that rarely changes and is the same for every report.
+bool isMetadata(const QString &path)
+{
+    return path.startsWith(QLatin1String("/product/")) || path.startsWith(QLatin1String("/field/bug/")) || path == QLatin1String("/version");
+}
+
+// QNAM serves cached responses without asking the server while they look fresh (max-age, Expires or heuristically
+// from Last-Modified), a Cache-Control request header doesn't change that. Stored entries are always expired, so
+// every use goes through a conditional request and the server decides whether the data is still current.
+class RevalidatingDiskCache : public QNetworkDiskCache
+{
+public:
+    using QNetworkDiskCache::QNetworkDiskCache;
+
+    QIODevice *prepare(const QNetworkCacheMetaData &metaData) override
+    {
+        return QNetworkDiskCache::prepare(expired(metaData));
+    }
+
+    void updateMetaData(const QNetworkCacheMetaData &metaData) override
+    {
+        QNetworkDiskCache::updateMetaData(expired(metaData));
+    }
+
+private:
+    static QNetworkCacheMetaData expired(QNetworkCacheMetaData metaData)
+    {
+        metaData.setExpirationDate(QDateTime::fromSecsSinceEpoch(0, QTimeZone::UTC));
+        return metaData;
+    }
+};
+} // namespace
+
 // Static container for global default connection.
 // We need a container here because the connection may be anything derived from
 // Connection and its effective type may change (e.g. in autotests).
@@ -37,7 +77,13 @@ void setConnection(Connection *newConnection)
 HTTPConnection::HTTPConnection(const QUrl &root, QObject *parent)
     : Connection(parent)
     , m_root(root)
+    // Deleted on the event loop, the last job holding on to it may let go of it while handling its reply.
+    // The global connection is destroyed after the event loop is gone, the manager then simply isn't cleaned up.
+    , m_manager(new QNetworkAccessManager, [](QNetworkAccessManager *manager) {
+        manager->deleteLater();
+    })
 {
+    m_manager->setRedirectPolicy(QNetworkRequest::NoLessSafeRedirectPolicy);
 }
 
 HTTPConnection::~HTTPConnection() = default;
@@ -50,7 +96,7 @@ void HTTPConnection::setToken(const QString &authToken)
 APIJob *HTTPConnection::get(const QString &path, const Query &query) const
 {
     qCDebug(BUGZILLA_LOG) << path << query.toString();
-    auto job = new NetworkAPIJob(url(path, query), [](QNetworkAccessManager &manager, QNetworkRequest &request) -> QNetworkReply * {
+    auto job = new NetworkAPIJob(m_manager, request(path, query), [](QNetworkAccessManager &manager, QNetworkRequest &request) -> QNetworkReply * {
         return manager.get(request);
     });
     return job;
@@ -59,7 +105,7 @@ APIJob *HTTPConnection::get(const QString &path, const Query &query) const
 APIJob *HTTPConnection::post(const QString &path, const QByteArray &data, const Query &query) const
 {
     qCDebug(BUGZILLA_LOG) << path << query.toString();
-    auto job = new NetworkAPIJob(url(path, query), [data](QNetworkAccessManager &manager, QNetworkRequest &request) -> QNetworkReply * {
+    auto job = new NetworkAPIJob(m_manager, request(path, query), [data](QNetworkAccessManager &manager, QNetworkRequest &request) -> QNetworkReply * {
         return manager.post(request, data);
     });
     return job;
@@ -68,7 +114,7 @@ APIJob *HTTPConnection::post(const QString &path, const QByteArray &data, const
 APIJob *HTTPConnection::put(const QString &path, const QByteArray &data, const Query &query) const
 {
     qCDebug(BUGZILLA_LOG) << path << query.toString();
-    auto job = new NetworkAPIJob(url(path, query), [data](QNetworkAccessManager &manager, QNetworkRequest &request) -> QNetworkReply * {
+    auto job = new NetworkAPIJob(m_manager, request(path, query), [data](QNetworkAccessManager &manager, QNetworkRequest &request) -> QNetworkReply * {
         return manager.put(request, data);
     });
     return job;
@@ -79,6 +125,41 @@ QUrl HTTPConnection::root() const
     return m_root;
 }
 
+void HTTPConnection::setMaxConnections(int connections)
+{
+    m_http1Configuration.setNumberOfConnectionsPerHost(connections);
+}
+
+void HTTPConnection::setCacheDirectory(const QString &directory)
+{
+    auto cache = new RevalidatingDiskCache(m_manager.get());
+    cache->setCacheDirectory(directory);
+    cache->setMaximumCacheSize(MAX_CACHE_SIZE);
+    m_manager->setCache(cache);
+}
+
+QNetworkRequest HTTPConnection::request(const QString &appendix, const Query &query) const
+{
+    QNetworkRequest request(url(appendix, query));
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json"_qba);
+    request.setRawHeader("Accept"_qba, "application/json"_qba);
+    request.setHeader(QNetworkRequest::UserAgentHeader, "DrKonqi"_qba);
+    // HTTP/2 servers multiplex all our requests over one connection. Otherwise up to m_http1Configuration
+    // connections are opened, and kept alive in between the requests of a report, which come in bursts.
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+    request.setAttribute(QNetworkRequest::ConnectionCacheExpiryTimeoutSecondsAttribute, 120);
+    request.setHttp1Configuration(m_http1Configuration);
+    // The token is part of the query, it must not end up in the cached URLs on disk. Logged in, metadata isn't cached.
+    if (isMetadata(appendix) && m_token.isEmpty()) {
+        // The cached entries are always expired, see RevalidatingDiskCache, they are only used after a 304.
+        request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferNetwork);
+    } else {
+        request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+        request.setAttribute(QNetworkRequest::CacheSaveControlAttribute, false);
+    }
+    return request;
+}
+
 QUrl HTTPConnection::url(const QString &appendix, Query query) const
 {
     QUrl url(m_root);
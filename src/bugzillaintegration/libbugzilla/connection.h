@@ -7,9 +7,13 @@
 #ifndef CONNECTION_H
 #define CONNECTION_H
 
+#include <QHttp1Configuration>
+#include <QNetworkRequest>
 #include <QObject>
 #include <QUrl>
 
+#include <memory>
+
 #include "apijob.h"
 #include "exceptions.h"
 #include "query.h"
@@ -55,11 +59,33 @@ public:
 
     QUrl root() const;
 
+    /**
+     * Limits the HTTP/1.1 connections opened to the server at a time, further
+     * requests wait for one of them. HTTP/2 servers multiplex all requests
+     * over one connection regardless.
+     */
+    void setMaxConnections(int connections);
+
+    /**
+     * Caches the responses of metadata requests (products, fields, version)
+     * in directory. They rarely change, cached responses are revalidated with
+     * conditional requests (ETag/Last-Modified) and, when unchanged, served
+     * from disk after nothing but a 304 from the server.
+     * Other requests are never cached, neither is anything while a token is
+     * set, it would be stored with the request URL.
+     */
+    void setCacheDirectory(const QString &directory);
+
 private:
     QUrl url(const QString &appendix, Query query) const;
+    QNetworkRequest request(const QString &appendix, const Query &query) const;
 
     QUrl m_root;
     QString m_token;
+    QHttp1Configuration m_http1Configuration;
+    // Shared by all our jobs so they reuse warm (kept alive, already TLS
+    // negotiated) connections. The jobs hold on to it, it may outlive us.
+    std::shared_ptr<QNetworkAccessManager> m_manager;
 
     Q_DISABLE_COPY_MOVE(HTTPConnection)
 };
@@ -0,0 +1,160 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "jsonstreamreader.h"
+
+#include <QJsonDocument>
+
+#include "bugzilla_debug.h"
+
+namespace Bugzilla
+{
+JsonStreamReader::JsonStreamReader(const QStringList &path)
+    : m_path(path)
+{
+}
+
+bool JsonStreamReader::matchesPath() const
+{
+    // the root container has no key
+    if (m_stack.size() != m_path.size() + 1) {
+        return false;
+    }
+    for (qsizetype i = 0; i < m_path.size(); ++i) {
+        const QString &key = m_path.at(i);
+        if (key != QLatin1String("*") && key.toUtf8() != m_stack.at(i + 1).key) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void JsonStreamReader::finishValue(QList<Value> &values)
+{
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(m_value, &error);
+    if (error.error != QJsonParseError::NoError) {
+        // left out, to the consumer it is as if the value was never sent
+        qCWarning(BUGZILLA_LOG) << "Failed to parse streamed value" << m_valueKey << error.errorString();
+    } else if (document.isObject()) {
+        values.append({QString::fromUtf8(m_valueKey), document.object()});
+    } else {
+        values.append({QString::fromUtf8(m_valueKey), document.array()});
+    }
+    m_value.clear();
+    m_valueKey.clear();
+}
+
+QList<JsonStreamReader::Value> JsonStreamReader::read(QByteArrayView chunk)
+{
+    QList<Value> values;
+
+    // Where the bytes go. Inside the streamed container they are captured
+    // into m_value, or dropped when they are no container value (e.g. the
+    // separating commas).
+    qsizetype flushed = 0;
+    const auto flush = [this, &chunk, &flushed](qsizetype end) {
+        const QByteArrayView bytes = chunk.sliced(flushed, end - flushed);
+        if (m_captureDepth >= 0) {
+            m_value += bytes;
+        } else if (m_streamDepth < 0) {
+            m_remainder += bytes;
+        }
+        flushed = end;
+    };
+
+    for (qsizetype i = 0; i < chunk.size(); ++i) {
+        const char c = chunk.at(i);
+
+        if (m_inString) {
+            if (m_escape) {
+                m_escape = false;
+            } else if (c == '\\') {
+                m_escape = true;
+            } else if (c == '"') {
+                m_inString = false;
+                if (m_collectingKey) {
+                    m_collectingKey = false;
+                    m_stack.last().currentKey = m_key;
+                    m_key.clear();
+                }
+                continue;
+            }
+            if (m_collectingKey) {
+                m_key += c;
+            }
+            continue;
+        }
+
+        switch (c) {
+        case '"':
+            m_inString = true;
+            // keys are only of interest outside of captured values
+            m_collectingKey = m_captureDepth < 0 && !m_stack.isEmpty() && m_stack.constLast().type == '{' && m_stack.constLast().expectKey;
+            break;
+        case ':':
+            if (!m_stack.isEmpty() && m_stack.constLast().type == '{') {
+                m_stack.last().expectKey = false;
+            }
+            break;
+        case ',':
+            if (!m_stack.isEmpty() && m_stack.constLast().type == '{') {
+                m_stack.last().expectKey = true;
+            }
+            break;
+        case '{':
+        case '[': {
+            QByteArray key;
+            if (!m_stack.isEmpty() && m_stack.constLast().type == '{') {
+                key = m_stack.constLast().currentKey;
+            }
+            if (m_captureDepth < 0 && m_stack.size() == m_streamDepth) {
+                flush(i);
+                m_captureDepth = m_stack.size();
+                m_valueKey = key;
+            }
+            m_stack.append({c, key, {}, c == '{'});
+            if (m_captureDepth < 0 && m_streamDepth < 0 && matchesPath()) {
+                // the container itself stays, empty
+                flush(i + 1);
+                m_streamDepth = m_stack.size();
+            }
+            break;
+        }
+        case '}':
+        case ']':
+            if (m_stack.isEmpty()) {
+                break;
+            }
+            if (m_captureDepth >= 0 && m_stack.size() == m_captureDepth + 1) {
+                flush(i + 1);
+                m_stack.removeLast();
+                m_captureDepth = -1;
+                finishValue(values);
+                break;
+            }
+            if (m_captureDepth < 0 && m_stack.size() == m_streamDepth) {
+                // drop whatever isn't a value and keep the closing bracket
+                flushed = i;
+                m_streamDepth = -1;
+            }
+            m_stack.removeLast();
+            break;
+        default:
+            break;
+        }
+    }
+    flush(chunk.size());
+
+    return values;
+}
+
+QByteArray JsonStreamReader::remainder() const
+{
+    return m_remainder;
+}
+
+} // namespace Bugzilla
@@ -0,0 +1,79 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QJsonValue>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+namespace Bugzilla
+{
+/**
+ * Reads a JSON document in chunks as they arrive and hands out the values of
+ * one container as soon as each of them is complete.
+ *
+ * The container is found by the keys leading to it from the document root,
+ * "*" matches any key. E.g. {"bugs"} streams the bugs of a bug search as well
+ * as the bugs (keyed by id) of a comment request. Only object and array values
+ * are streamed, anything else in the container is skipped.
+ *
+ * Streamed values are not kept, the remainder is the document without them and
+ * still holds everything else, notably error objects. Only the value being
+ * read is buffered, so a large response never is in memory all at once.
+ *
+ * The reader doesn't validate the document, malformed input results in a
+ * malformed remainder which fails to parse later on.
+ */
+class JsonStreamReader
+{
+public:
+    struct Value {
+        // key in the container, empty for arrays
+        QString key;
+        QJsonValue value;
+    };
+
+    explicit JsonStreamReader(const QStringList &path);
+
+    // Reads the next chunk, returns the values it completed.
+    QList<Value> read(QByteArrayView chunk);
+
+    // The document read so far without the streamed values.
+    QByteArray remainder() const;
+
+private:
+    struct Container {
+        char type; // '{' or '['
+        QByteArray key; // in the parent, empty in arrays
+        QByteArray currentKey; // of the value being read, objects only
+        bool expectKey = false;
+    };
+
+    [[nodiscard]] bool matchesPath() const;
+    void finishValue(QList<Value> &values);
+
+    const QStringList m_path;
+    QList<Container> m_stack;
+
+    bool m_inString = false;
+    bool m_escape = false;
+    bool m_collectingKey = false;
+    QByteArray m_key;
+
+    // depth of the streamed container and of the value being captured, -1 when outside of them
+    qsizetype m_streamDepth = -1;
+    qsizetype m_captureDepth = -1;
+
+    QByteArray m_remainder;
+    QByteArray m_value;
+    QByteArray m_valueKey;
+};
+
+} // namespace Bugzilla
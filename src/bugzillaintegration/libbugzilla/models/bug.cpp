@@ -86,6 +86,11 @@ qint64 Bug::dupe_of() const
     return m_dupe_of;
 }
 
+QDateTime Bug::last_change_time() const
+{
+    return m_last_change_time;
+}
+
 qint64 Bug::id() const
 {
     return m_id;
@@ -7,6 +7,7 @@
 #ifndef BUG_H
 #define BUG_H
 
+#include <QDateTime>
 #include <QObject>
 #include <QPointer>
 
@@ -67,6 +68,7 @@ private:
     Q_PROPERTY(Status status READ status MEMBER m_status NOTIFY changed)
     Q_PROPERTY(Resolution resolution READ resolution MEMBER m_resolution NOTIFY changed)
     Q_PROPERTY(qint64 dupe_of READ dupe_of MEMBER m_dupe_of NOTIFY changed)
+    Q_PROPERTY(QDateTime last_change_time READ last_change_time MEMBER m_last_change_time NOTIFY changed)
 
     // Custom fields (versionfixedin etc) are only available via customField().
 
@@ -91,6 +93,7 @@ public:
     QString severity() const;
     bool is_open() const;
     qint64 dupe_of() const;
+    QDateTime last_change_time() const;
 
 Q_SIGNALS:
     void commentsChanged();
@@ -109,6 +112,7 @@ private:
     Status m_status = Status::Unknown;
     Resolution m_resolution = Resolution::Unknown;
     qint64 m_dupe_of = -1;
+    QDateTime m_last_change_time;
 };
 
 } // namespace Bugzilla
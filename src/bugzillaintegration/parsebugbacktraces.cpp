@@ -8,86 +8,36 @@
 
 #include "parsebugbacktraces.h"
 
-#include "parser/backtraceparser.h"
+#include "parser/backtraceparsergdb.h"
 
-typedef QList<BacktraceLine>::const_iterator BacktraceConstIterator;
-
-BacktraceConstIterator findCrashStackFrame(BacktraceConstIterator it, BacktraceConstIterator itEnd)
-{
-    BacktraceConstIterator result = itEnd;
-
-    // find the beginning of the crash
-    for (; it != itEnd; ++it) {
-        if (it->type() == BacktraceLine::KCrash) {
-            result = it;
-            break;
-        }
-    }
-
-    // find the beginning of the stack frame
-    for (it = result; it != itEnd; ++it) {
-        if (it->type() == BacktraceLine::StackFrame) {
-            result = it;
-            break;
-        }
-    }
-
-    return result;
-}
+#include <algorithm>
 
 // TODO improve this stuff, it is just a HACK
-ParseBugBacktraces::DuplicateRating rating(BacktraceConstIterator it, BacktraceConstIterator itEnd, BacktraceConstIterator it2, BacktraceConstIterator itEnd2)
+ParseBugBacktraces::DuplicateRating rating(const ParseBugBacktraces::Signature &signature, const ParseBugBacktraces::Signature &signature2)
 {
-    int matches = 0;
-    int lines = 0;
-
-    it = findCrashStackFrame(it, itEnd);
-    it2 = findCrashStackFrame(it2, itEnd2);
-
-    while (it != itEnd && it2 != itEnd2) {
-        if (it->type() == BacktraceLine::StackFrame && it2->type() == BacktraceLine::StackFrame) {
-            ++lines;
-            if (it->frameNumber() == it2->frameNumber() && it->functionName() == it2->functionName()) {
-                ++matches;
-            }
-            ++it;
-            ++it2;
-            continue;
-        }
-
-        // if iters do not point to emptylines or a stackframe increase them
-        if (it->type() != BacktraceLine::StackFrame && it->type() != BacktraceLine::EmptyLine) {
-            ++it;
-            continue;
-        }
-        if (it2->type() != BacktraceLine::StackFrame && it2->type() != BacktraceLine::EmptyLine) {
-            ++it2;
-            continue;
-        }
-
-        // one bt is shorter than the other
-        if (it->type() == BacktraceLine::StackFrame && it2->type() == BacktraceLine::EmptyLine) {
-            ++lines;
-            ++it;
-            continue;
-        }
-        if (it2->type() == BacktraceLine::StackFrame && it->type() == BacktraceLine::EmptyLine) {
-            ++lines;
-            ++it2;
-            continue;
+    const qsizetype overlap = std::min(signature.frames.size(), signature2.frames.size());
+    qsizetype lines = overlap;
+    qsizetype matches = 0;
+    for (qsizetype i = 0; i < overlap; ++i) {
+        const ParseBugBacktraces::Frame &frame = signature.frames.at(i);
+        const ParseBugBacktraces::Frame &frame2 = signature2.frames.at(i);
+        if (frame.number == frame2.number && frame.function == frame2.function) {
+            ++matches;
         }
+    }
 
-        if (it->type() == BacktraceLine::EmptyLine && it2->type() == BacktraceLine::EmptyLine) {
-            // done
-            break;
-        }
+    // one bt is shorter than the other, the remaining frames only count when the shorter one ended at an empty line
+    // rather than with the backtrace
+    const ParseBugBacktraces::Signature &shorter = signature.frames.size() < signature2.frames.size() ? signature : signature2;
+    if (shorter.blockEnded) {
+        lines = std::max(signature.frames.size(), signature2.frames.size());
     }
 
     if (!lines) {
         return ParseBugBacktraces::NoDuplicate;
     }
 
-    const int rating = matches * 100 / lines;
+    const qsizetype rating = matches * 100 / lines;
     if (rating == 100) {
         return ParseBugBacktraces::PerfectDuplicate;
     } else if (rating >= 90) {
@@ -104,9 +54,80 @@ ParseBugBacktraces::ParseBugBacktraces(const QList<Bugzilla::Comment::Ptr> &comm
     , m_comments(comments)
 {
     m_parser = BacktraceParser::newParser(QStringLiteral("gdb"), this);
+    // We run on a pool thread already. Parsing here also keeps the names of the comments in the caller's
+    // SymbolTable::Session, which only covers its own thread.
+    if (auto gdbParser = qobject_cast<BacktraceParserGdb *>(m_parser)) {
+        gdbParser->setThreadPool(nullptr);
+    }
     m_parser->connectToGenerator(this);
 }
 
+ParseBugBacktraces::ParseBugBacktraces(const QList<Signature> &signatures, QObject *parent)
+    : QObject(parent)
+    , m_signatures(signatures)
+{
+}
+
+QList<ParseBugBacktraces::Signature> ParseBugBacktraces::signatures() const
+{
+    return m_signatures;
+}
+
+QList<CrashSignature> ParseBugBacktraces::crashSignatures() const
+{
+    return m_crashSignatures;
+}
+
+ParseBugBacktraces::Signature ParseBugBacktraces::signatureOf(const StructuredBacktrace &backtrace)
+{
+    // compare the stack frames from the first one below the crash handler on up to the end of their block
+    const StructuredBacktrace::Thread *thread = backtrace.crashedThread();
+    if (!thread) {
+        return {};
+    }
+
+    const QList<BacktraceLine> &lines = backtrace.lines();
+    auto it = std::find_if(lines.cbegin(), lines.cend(), [](const BacktraceLine &line) {
+        return line.type() == BacktraceLine::KCrash;
+    });
+    Signature signature;
+    // frames of the crashed thread, the block may go on past the next thread header
+    qsizetype threadFrames = 0;
+    bool inCrashedThread = true;
+    for (; it != lines.cend(); ++it) {
+        if (it->type() == BacktraceLine::StackFrame) {
+            signature.frames.append({it->frameNumber(), it->functionId()});
+            if (inCrashedThread) {
+                ++threadFrames;
+            }
+        } else if (it->type() == BacktraceLine::ThreadStart) {
+            inCrashedThread = false;
+        } else if (it->type() == BacktraceLine::EmptyLine && !signature.frames.isEmpty()) {
+            signature.blockEnded = true;
+            break;
+        }
+    }
+
+    const QList<CrashSignature::UsefulFrame> usefulFrames = CrashSignature::usefulFrames(backtrace);
+    for (const CrashSignature::UsefulFrame &frame : usefulFrames) {
+        if (const qsizetype index = frame.index - thread->crashFrame; index < threadFrames) {
+            signature.frames[index].normalizedFunction = SymbolTable::intern(frame.name);
+        }
+    }
+    return signature;
+}
+
+BacktraceSimilarity::Frames ParseBugBacktraces::similarityFrames(const Signature &signature)
+{
+    BacktraceSimilarity::Frames frames;
+    for (const Frame &frame : signature.frames) {
+        if (frame.normalizedFunction != SymbolTable::EmptyId) {
+            frames.append(frame.normalizedFunction);
+        }
+    }
+    return frames;
+}
+
 void ParseBugBacktraces::parse()
 {
     for (const auto &comment : m_comments) {
@@ -125,24 +146,30 @@ void ParseBugBacktraces::parse(const QString &comment)
         end = comment.indexOf(QLatin1Char('\n'), start);
         Q_EMIT newLine(comment.mid(start, (end != -1 ? end - start + 1 : end)));
     } while (end != -1);
+    // the end of the comment is the end of the backtrace, the parser merges whatever it still has pending
+    Q_EMIT newLine(QString());
 
     // accepts anything as backtrace, the start of the backtrace is searched later anyway
-    m_backtraces << m_parser->parsedBacktraceLines();
+    // (backtraces without crashed thread can't match anything)
+    const StructuredBacktrace backtrace = m_parser->structuredBacktrace();
+    if (Signature signature = signatureOf(backtrace); !signature.frames.isEmpty()) {
+        m_signatures << signature;
+    }
+    if (CrashSignature crashSignature = CrashSignature::fromBacktrace(backtrace); !crashSignature.isEmpty()) {
+        m_crashSignatures << crashSignature;
+    }
 }
 
-ParseBugBacktraces::DuplicateRating ParseBugBacktraces::findDuplicate(const QList<BacktraceLine> &backtrace)
+ParseBugBacktraces::DuplicateRating ParseBugBacktraces::findDuplicate(const StructuredBacktrace &backtrace)
 {
-    if (m_backtraces.isEmpty() || backtrace.isEmpty()) {
+    const Signature signature = signatureOf(backtrace);
+    if (m_signatures.isEmpty() || signature.frames.isEmpty()) {
         return NoDuplicate;
     }
 
     DuplicateRating bestRating = NoDuplicate;
-    DuplicateRating currentRating = NoDuplicate;
-
-    QList<QList<BacktraceLine>>::const_iterator itBts;
-    QList<QList<BacktraceLine>>::const_iterator itEndBts = m_backtraces.constEnd();
-    for (itBts = m_backtraces.constBegin(); itBts != itEndBts; ++itBts) {
-        currentRating = rating(backtrace.constBegin(), backtrace.constEnd(), itBts->constBegin(), itBts->constEnd());
+    for (const Signature &bugSignature : std::as_const(m_signatures)) {
+        const DuplicateRating currentRating = rating(signature, bugSignature);
         if (currentRating < bestRating) {
             bestRating = currentRating;
         }
@@ -155,4 +182,14 @@ ParseBugBacktraces::DuplicateRating ParseBugBacktraces::findDuplicate(const QLis
     return bestRating;
 }
 
+double ParseBugBacktraces::similarity(const StructuredBacktrace &backtrace) const
+{
+    const BacktraceSimilarity similarity(similarityFrames(signatureOf(backtrace)));
+    double best = 0;
+    for (const Signature &bugSignature : m_signatures) {
+        best = std::max(best, similarity.score(similarityFrames(bugSignature)));
+    }
+    return best;
+}
+
 #include "moc_parsebugbacktraces.cpp"
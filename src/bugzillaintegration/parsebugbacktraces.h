@@ -10,7 +10,10 @@
 #define PARSE_BUG_BACKTRACES_H
 
 #include "bugzillalib.h"
-#include "parser/backtraceline.h"
+#include "parser/backtracesimilarity.h"
+#include "parser/crashsignature.h"
+#include "parser/structuredbacktrace.h"
+#include "parser/symboltable.h"
 
 class BacktraceParser;
 
@@ -23,10 +26,54 @@ class ParseBugBacktraces : QObject
 {
     Q_OBJECT
 public:
+    /**
+     * A frame of the crashed thread of a backtrace, this is what backtraces are compared by.
+     */
+    struct Frame {
+        int number = -1;
+        SymbolTable::Id function = SymbolTable::EmptyId;
+        // the normalized function name of useful frames, see CrashSignature::usefulFrames()
+        SymbolTable::Id normalizedFunction = SymbolTable::EmptyId;
+
+        bool operator==(const Frame &other) const = default;
+    };
+    /**
+     * The frames below the crash handler up to the end of their block, i.e. the crashed thread.
+     */
+    struct Signature {
+        QList<Frame> frames;
+        // the frames ended at an empty line rather than with the backtrace
+        bool blockEnded = false;
+
+        bool operator==(const Signature &other) const = default;
+    };
+
     explicit ParseBugBacktraces(const QList<Bugzilla::Comment::Ptr> &comments, QObject *parent = nullptr);
+    /**
+     * Compares against signatures that were parsed before (e.g. cached ones), there is nothing to parse().
+     */
+    explicit ParseBugBacktraces(const QList<Signature> &signatures, QObject *parent = nullptr);
 
     void parse();
 
+    /**
+     * @return the signatures of the parsed backtraces that have a crashed thread
+     */
+    QList<Signature> signatures() const;
+    /**
+     * @return the normalized crash signatures of the parsed backtraces, for indexing (see DuplicateIndex)
+     */
+    QList<CrashSignature> crashSignatures() const;
+
+    /**
+     * @return the signature of backtrace, without frames if it has no crashed thread
+     */
+    static Signature signatureOf(const StructuredBacktrace &backtrace);
+    /**
+     * @return the useful frames of signature, what similarity() compares
+     */
+    static BacktraceSimilarity::Frames similarityFrames(const Signature &signature);
+
     enum DuplicateRating {
         PerfectDuplicate, // functionnames and stackframe numer match
         MostLikelyDuplicate, // functionnames and stackframe numer match >=90%
@@ -34,7 +81,12 @@ public:
         NoDuplicate, // functionnames and stackframe numer match <60%
     };
 
-    DuplicateRating findDuplicate(const QList<BacktraceLine> &backtrace);
+    DuplicateRating findDuplicate(const StructuredBacktrace &backtrace);
+    /**
+     * @return how similar the most similar of the parsed backtraces is to backtrace, between 0 and 1
+     * @see BacktraceSimilarity
+     */
+    double similarity(const StructuredBacktrace &backtrace) const;
 
 Q_SIGNALS:
     void starting();
@@ -46,7 +98,8 @@ private:
 private:
     BacktraceParser *m_parser = nullptr;
     const QList<Bugzilla::Comment::Ptr> m_comments;
-    QList<QList<BacktraceLine>> m_backtraces;
+    QList<Signature> m_signatures;
+    QList<CrashSignature> m_crashSignatures;
 };
 
 #endif
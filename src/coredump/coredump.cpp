@@ -18,26 +18,11 @@ Coredump::Coredump(QByteArray cursor, EntriesHash data)
 {
 }
 
-Coredump::Coredump(const QJsonDocument &document)
-    : Coredump(QByteArray() /* not from journal, has no cursor */, documentToHash(document))
-{
-}
-
 QByteArray Coredump::keyFilename()
 {
     return QByteArrayLiteral("COREDUMP_FILENAME");
 }
 
-Coredump::EntriesHash Coredump::documentToHash(const QJsonDocument &document)
-{
-    const QVariantMap variantMap = document.toVariant().toMap();
-    EntriesHash hash;
-    for (auto it = variantMap.cbegin(); it != variantMap.cend(); ++it) {
-        hash.insert(it.key().toUtf8(), it->value<QByteArray>());
-    }
-    return hash;
-}
-
 QByteArray Coredump::keyPickup()
 {
     return "_DRKONQI_PICKUP"_ba;
@@ -7,7 +7,6 @@
 
 #include <QByteArray>
 #include <QHash>
-#include <QJsonDocument>
 #include <QString>
 
 #include "memory.h"
@@ -18,7 +17,6 @@ public:
     using EntriesHash = QHash<QByteArray, QByteArray>;
 
     Coredump(QByteArray cursor, EntriesHash data);
-    explicit Coredump(const QJsonDocument &document);
 
     ~Coredump() = default;
 
@@ -38,6 +36,5 @@ public:
     const QString systemd_unit;
 
 private:
-    static EntriesHash documentToHash(const QJsonDocument &document);
     Q_DISABLE_COPY_MOVE(Coredump)
 };
@@ -6,6 +6,7 @@
 #include "coredumpwatcher.h"
 
 #include <cerrno>
+#include <cstring>
 #include <optional>
 #include <utility>
 
@@ -18,6 +19,33 @@
 
 using namespace Qt::StringLiterals;
 
+// Reads a single field of the current entry, without going through all of its data.
+// Returns nullopt if the entry doesn't have the field.
+static std::optional<QByteArray> journalField(sd_journal *context, const char *field)
+{
+    const void *data = nullptr;
+    size_t length = 0;
+    if (sd_journal_get_data(context, field, &data, &length) < 0) {
+        return std::nullopt;
+    }
+    // Same as with SD_JOURNAL_FOREACH_DATA the data is FIELD=value
+    const auto prefixSize = strlen(field) + 1;
+    if (length < prefixSize) {
+        return std::nullopt;
+    }
+    return QByteArray(static_cast<const char *>(data) + prefixSize, static_cast<qsizetype>(length - prefixSize));
+}
+
+// Whether the current entry has the field, without copying its data.
+static bool hasJournalField(sd_journal *context, const char *field)
+{
+    const void *data = nullptr;
+    size_t length = 0;
+    return sd_journal_get_data(context, field, &data, &length) >= 0;
+}
+
+// Materializes every field of the current entry. Only done for entries that made it through the filters, the
+// entries of a boot can be many and are mostly rejected.
 static std::optional<Coredump> makeDump(sd_journal *context)
 {
     auto cursorExpected = contextual_owning_ptr_call<char>(sd_journal_get_cursor, context, std::free);
@@ -36,25 +64,27 @@ static std::optional<Coredump> makeDump(sd_journal *context)
         Q_ASSERT(dataSize >= 0);
         Q_ASSERT(static_cast<quint64>(dataSize) == length);
 
-        QByteArray entry(static_cast<const char *>(data), dataSize);
-        const auto offset = entry.indexOf('=');
-        if (offset < 0) {
-            qWarning() << "this entry looks funny it has no separating = character" << entry;
+        // Look at the raw data before copying anything, the COREDUMP field can be the entire core.
+        const auto raw = static_cast<const char *>(data);
+        const auto separator = static_cast<const char *>(memchr(raw, '=', length));
+        if (!separator) {
+            qWarning() << "this entry looks funny it has no separating = character" << QByteArrayView(raw, dataSize);
             continue;
         }
+        const auto offset = separator - raw;
 
-        const QByteArray key = entry.left(offset);
-        if (key == QByteArrayLiteral("COREDUMP")) {
+        const QByteArrayView key(raw, offset);
+        if (key == QByteArrayView("COREDUMP")) {
             // The literal COREDUMP= entry is the actual core when configured for journal storage in coredump.conf.
             // Synthesize a filename instead so we can use the same validity checks for all storage types.
             entries.insert(Coredump::keyFilename(), QByteArrayLiteral("/dev/null"));
             continue;
         }
 
-        const QByteArray value = entry.mid(offset + 1);
+        const QByteArray value(separator + 1, dataSize - offset - 1);
 
         // Always add to raw data, they get serialized back into the INI file for drkonqi.
-        entries.insert(key, value);
+        entries.insert(key.toByteArray(), value);
     }
 
     return std::make_optional<Coredump>(cursorExpected.value.get(), entries);
@@ -74,26 +104,33 @@ void CoredumpWatcher::processLog()
     int i = 0;
     while (sd_journal_next(context.get()) > 0) {
         ++i;
-        const auto optionalDump = makeDump(context.get());
-        if (!optionalDump.has_value()) {
-            qWarning() << "Failed to make a dump :O";
-            continue;
-        }
-
-        const Coredump &dump = optionalDump.value();
-        if (!dump.systemd_unit.startsWith(instanceFilter)) {
+        // Filter on the few fields we need before reading the entire entry.
+        const QString systemdUnit = QString::fromLocal8Bit(journalField(context.get(), "_SYSTEMD_UNIT").value_or(QByteArray()));
+        if (!systemdUnit.startsWith(instanceFilter)) {
             // Older systemds have trouble templating a correct instance. We only
             // perform a startsWith check here, but will filter more aggressively
             // whenever possible via the constructor.
             continue;
         }
-        if (dump.exe.isEmpty() && dump.filename.isEmpty()) {
+        const auto hasValue = [this](const char *field) {
+            return !journalField(context.get(), field).value_or(QByteArray()).isEmpty();
+        };
+        // The literal COREDUMP field counts as a filename, makeDump synthesizes one for it.
+        if (!hasValue("COREDUMP_EXE") && !hasValue(Coredump::keyFilename().constData()) && !hasJournalField(context.get(), "COREDUMP")) {
             qDebug() << "Entry doesn't look like a dump. This may have been a vaccum run. Nothing to process.";
             // Do not finish here. Vaccum log entires are created from real coredump processes. We should eventually
             // find a dump.
             continue;
         }
 
+        const auto optionalDump = makeDump(context.get());
+        if (!optionalDump.has_value()) {
+            qWarning() << "Failed to make a dump :O";
+            continue;
+        }
+
+        const Coredump &dump = optionalDump.value();
+
         qDebug() << dump.exe << dump.pid << dump.filename;
 
         Q_EMIT newDump(dump);
@@ -117,6 +154,13 @@ void CoredumpWatcher::start()
 {
     Q_ASSERT(context);
 
+    // Compressed fields are only decompressed up to the threshold. The fields we use are short, or like MESSAGE only
+    // matter at the start, but COREDUMP holds the entire core when the journal stores it.
+    constexpr size_t dataThreshold = 16 * 1024;
+    if (sd_journal_set_data_threshold(context.get(), dataThreshold) < 0) {
+        qWarning() << "Failed to set the data threshold, fields are read in full";
+    }
+
     sd_journal_flush_matches(context.get()); // reset match
     if (sd_journal_add_match(context.get(), "SYSLOG_IDENTIFIER=systemd-coredump", 0) != 0) {
         Q_EMIT error(QStringLiteral("Failed to install id match"));
@@ -169,7 +213,11 @@ void CoredumpWatcher::start()
         processLog();
     });
 
-    if (int ret = sd_journal_seek_head(context.get()); ret != 0) {
+    if (!resumeCursor.isEmpty() && seekCursor()) {
+        qDebug() << "Resuming after" << resumeCursor;
+    } else if (resumeTime.count() > 0 && sd_journal_seek_realtime_usec(context.get(), resumeTime.count()) == 0) {
+        qDebug() << "Resuming at" << resumeTime.count();
+    } else if (int ret = sd_journal_seek_head(context.get()); ret != 0) {
         errnoError(QStringLiteral("Failed to go to tail"), -fd);
         return;
     }
@@ -182,4 +230,31 @@ void CoredumpWatcher::addMatch(const QString &str)
     matches.push_back(str);
 }
 
+void CoredumpWatcher::setResumeCursor(const QByteArray &cursor)
+{
+    resumeCursor = cursor;
+}
+
+void CoredumpWatcher::setResumeTime(std::chrono::system_clock::time_point time)
+{
+    resumeTime = std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch());
+}
+
+bool CoredumpWatcher::seekCursor()
+{
+    if (int ret = sd_journal_seek_cursor(context.get(), resumeCursor.constData()); ret != 0) {
+        qWarning() << "Failed to seek to cursor" << resumeCursor << strerror(-ret);
+        return false;
+    }
+    // Seeking only positions the journal, the next sd_journal_next() would return the entry of the cursor itself.
+    // Step onto it so processLog continues with the following entry. If the entry has been vacuumed in the meantime
+    // we are on the closest entry instead, which hasn't been processed yet, step back so it gets processed.
+    if (sd_journal_next(context.get()) > 0 && sd_journal_test_cursor(context.get(), resumeCursor.constData()) <= 0) {
+        if (sd_journal_previous(context.get()) <= 0) {
+            sd_journal_seek_head(context.get()); // the closest entry is the first one
+        }
+    }
+    return true;
+}
+
 #include "moc_coredumpwatcher.cpp"
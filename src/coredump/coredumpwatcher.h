@@ -8,6 +8,8 @@
 #include <QObject>
 #include <QSocketNotifier>
 
+#include <chrono>
+
 #include <systemd/sd-journal.h>
 
 #include "memory.h"
@@ -21,6 +23,10 @@ public:
 
     // must be called before start!
     void addMatch(const QString &str);
+    // must be called before start! Resumes after the entry of cursor instead of at the head of the journal.
+    void setResumeCursor(const QByteArray &cursor);
+    // must be called before start! Starts at the entries written since time, when there is no cursor to resume after.
+    void setResumeTime(std::chrono::system_clock::time_point time);
     void start();
 
 Q_SIGNALS:
@@ -32,6 +38,7 @@ Q_SIGNALS:
 
 private:
     void processLog();
+    bool seekCursor();
     void errnoError(const QString &msg, int err);
 
     const std::unique_ptr<sd_journal> context = nullptr;
@@ -40,4 +47,6 @@ private:
     const QString instance;
     const QString instanceFilter; // systemd-coredump@%1 instance name
     QStringList matches;
+    QByteArray resumeCursor;
+    std::chrono::microseconds resumeTime{0};
 };
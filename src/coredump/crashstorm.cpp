@@ -0,0 +1,215 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+*/
+
+#include "crashstorm.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QList>
+#include <QScopeGuard>
+#include <QStringList>
+
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include "coredump.h"
+
+using namespace std::chrono_literals;
+using namespace Qt::StringLiterals;
+
+namespace
+{
+constexpr int SIGNATURE_FRAMES = 3;
+constexpr auto SLOT_POLL_INTERVAL = 500ms;
+
+int openLockFile(const QString &path)
+{
+    return open(QFile::encodeName(path).constData(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+}
+
+// Frames that are the same for every crash of their kind, they say nothing about where it crashed.
+bool isCrashMachinery(QByteArrayView function, QByteArrayView module)
+{
+    return module.startsWith("libc.so") || module.startsWith("libpthread.so") || module.startsWith("libKF6Crash.so") || function.startsWith("qt_message")
+        || function.startsWith("QMessageLogger::") || function.startsWith("qt_assert") || function.startsWith("qAbort");
+}
+} // namespace
+
+CrashStorm::Slot::Slot(int fd)
+    : m_fd(fd)
+{
+}
+
+CrashStorm::Slot::~Slot()
+{
+    close(m_fd); // also releases the lock
+}
+
+CrashStorm::CrashStorm(QString directory, std::chrono::milliseconds window, int maxConcurrent)
+    : m_directory(std::move(directory))
+    , m_window(window)
+    , m_maxConcurrent(maxConcurrent)
+{
+}
+
+QStringList CrashStorm::groupPaths(const Coredump &dump) const
+{
+    QList<QByteArray> groups;
+    if (!dump.exe.isEmpty()) {
+        groups << "exe:"_ba + dump.exe.toUtf8();
+    }
+    if (const QByteArray signature = CrashStorm::signature(dump.m_rawData.value("MESSAGE"_ba)); !signature.isEmpty()) {
+        groups << "signature:"_ba + signature;
+    }
+
+    QStringList paths;
+    for (const QByteArray &group : std::as_const(groups)) {
+        paths << m_directory + '/'_L1 + QString::fromLatin1(QCryptographicHash::hash(group, QCryptographicHash::Sha1).toHex());
+    }
+    return paths;
+}
+
+int CrashStorm::lockGroups() const
+{
+    QDir().mkpath(m_directory);
+    const int lockFd = openLockFile(m_directory + "/groups.lock"_L1);
+    if (lockFd < 0 || flock(lockFd, LOCK_EX) != 0) {
+        qWarning() << "Failed to lock crash groups in" << m_directory << strerror(errno);
+        if (lockFd >= 0) {
+            close(lockFd);
+        }
+        return -1;
+    }
+    return lockFd;
+}
+
+bool CrashStorm::coalesce(const Coredump &dump)
+{
+    const int lockFd = lockGroups();
+    if (lockFd < 0) {
+        return false;
+    }
+    auto unlock = qScopeGuard([lockFd] {
+        close(lockFd);
+    });
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const QStringList paths = groupPaths(dump);
+    for (const QString &path : paths) {
+        QFile file(path);
+        if (file.open(QFile::ReadOnly) && now - file.readAll().toLongLong() < m_window.count()) {
+            qDebug() << "Coalescing crash into its group" << path;
+            return true;
+        }
+    }
+
+    // The window starts with the first dump of a group, a storm outlasting it gets another dump handled per window.
+    const QByteArray time = QByteArray::number(now);
+    for (const QString &path : paths) {
+        QFile file(path);
+        if (!file.open(QFile::WriteOnly | QFile::Truncate) || file.write(time) < 0) {
+            qWarning() << "Failed to record crash group" << path << file.errorString();
+            continue;
+        }
+        m_recorded.insert(path, time);
+    }
+    return false;
+}
+
+void CrashStorm::release(const Coredump &dump)
+{
+    const int lockFd = lockGroups();
+    if (lockFd < 0) {
+        return;
+    }
+    auto unlock = qScopeGuard([lockFd] {
+        close(lockFd);
+    });
+
+    const QStringList paths = groupPaths(dump);
+    for (const QString &path : paths) {
+        const QByteArray time = m_recorded.take(path);
+        if (time.isEmpty()) {
+            continue;
+        }
+        // Once the window passed another dump may have recorded the group anew, that one stays.
+        QFile file(path);
+        if (file.open(QFile::ReadOnly) && file.readAll() == time) {
+            file.close();
+            file.remove();
+        }
+    }
+}
+
+std::unique_ptr<CrashStorm::Slot> CrashStorm::acquireSlot(std::chrono::milliseconds timeout)
+{
+    QDir().mkpath(m_directory);
+    const QDeadlineTimer deadline(timeout);
+    while (true) {
+        for (int i = 0; i < m_maxConcurrent; ++i) {
+            const int fd = openLockFile(m_directory + "/slot-%1"_L1.arg(i));
+            if (fd < 0) {
+                continue;
+            }
+            if (flock(fd, LOCK_EX | LOCK_NB) == 0) {
+                return std::make_unique<Slot>(fd);
+            }
+            close(fd);
+        }
+        if (deadline.hasExpired()) {
+            return nullptr;
+        }
+        std::this_thread::sleep_for(SLOT_POLL_INTERVAL);
+    }
+}
+
+QByteArray CrashStorm::signature(const QByteArray &message)
+{
+    // Stack trace of thread 1234:
+    // #0  0x00007f3c5b4a9d2c __pthread_kill_implementation (libc.so.6 + 0x8ed2c)
+    // #1  0x00007f3c5b45bf86 raise (libc.so.6 + 0x40f86)
+    // #2  0x000055d0c4b2a1f0 n/a (dragon + 0x2a1f0)
+    QList<QByteArray> frames;
+    bool inTrace = false;
+    const QList<QByteArray> lines = message.split('\n');
+    for (const QByteArray &rawLine : lines) {
+        const QByteArray line = rawLine.trimmed();
+        if (!line.startsWith('#')) {
+            if (inTrace) {
+                break; // only the first thread, that's the crashing one
+            }
+            continue;
+        }
+        inTrace = true;
+
+        // Drop the frame number and the address, they vary between processes.
+        const QList<QByteArray> parts = line.simplified().split(' ');
+        if (parts.size() < 3) {
+            continue;
+        }
+        const QByteArray frame = parts.mid(2).join(' ');
+        const qsizetype moduleStart = frame.lastIndexOf(" (");
+        const QByteArrayView function = QByteArrayView(frame).first(moduleStart < 0 ? frame.size() : moduleStart);
+        const QByteArrayView module = moduleStart < 0 ? QByteArrayView() : QByteArrayView(frame).sliced(moduleStart + 2);
+        if (isCrashMachinery(function, module)) {
+            continue;
+        }
+
+        frames << frame;
+        if (frames.size() == SIGNATURE_FRAMES) {
+            return frames.join('\n');
+        }
+    }
+    return {};
+}
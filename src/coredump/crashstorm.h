@@ -0,0 +1,64 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <chrono>
+#include <memory>
+
+class Coredump;
+
+// Keeps crash storms, e.g. a library update breaking a bunch of applications at once, from flooding the session with
+// drkonqis and notifications. Dumps are grouped by exe and by crash signature, only the first dump of a group within
+// the window is handled, and only so many dumps are handled at the same time.
+//
+// There is a launcher process per dump, so the state is shared through files in directory. Locks are flock()s and
+// go away with the process holding them.
+class CrashStorm
+{
+public:
+    // Held for as long as it lives, see acquireSlot().
+    class Slot
+    {
+    public:
+        explicit Slot(int fd);
+        ~Slot();
+
+    private:
+        const int m_fd;
+        Q_DISABLE_COPY_MOVE(Slot)
+    };
+
+    explicit CrashStorm(QString directory, std::chrono::milliseconds window = std::chrono::minutes(2), int maxConcurrent = 3);
+
+    // Records the dump's groups. True when a dump of the same exe or signature was recorded within the window
+    // already, this one needn't be handled.
+    bool coalesce(const Coredump &dump);
+    // Forgets the groups coalesce() recorded for dump, when it didn't get handled after all. The next dump of its
+    // groups is then handled rather than coalesced into it.
+    void release(const Coredump &dump);
+
+    // Waits for one of the maxConcurrent slots. Null when none became free within timeout.
+    std::unique_ptr<Slot> acquireSlot(std::chrono::milliseconds timeout);
+
+    // Signature of the stack trace systemd-coredump puts into the MESSAGE of a dump: the top frames with the crash
+    // handling machinery (libc's raise and abort, qFatal, KCrash) skipped. Empty when there aren't enough frames.
+    static QByteArray signature(const QByteArray &message);
+
+private:
+    QStringList groupPaths(const Coredump &dump) const;
+    // Exclusive access to the group files, -1 on failure. Closing the fd unlocks.
+    int lockGroups() const;
+
+    QString m_directory;
+    std::chrono::milliseconds m_window;
+    int m_maxConcurrent;
+    QHash<QString, QByteArray> m_recorded; // group path => time written into it
+};
@@ -6,7 +6,6 @@
 #include <QCoreApplication>
 #include <QDebug>
 #include <QFile>
-#include <QJsonDocument>
 #include <QLibraryInfo>
 #include <QPluginLoader>
 #include <QProcess>
@@ -17,6 +16,7 @@
 #include <cerrno>
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <tuple>
 #include <utility>
 
@@ -25,7 +25,9 @@
 #include <unistd.h>
 
 #include "../coredump.h"
+#include "../crashstorm.h"
 #include "../metadata.h"
+#include "../protocol.h"
 #include "../socket.h"
 #include "DumpTruckInterface.h"
 
@@ -45,6 +47,12 @@ static QString drkonqiExe()
     return exec;
 }
 
+static CrashStorm &crashStorm()
+{
+    static CrashStorm storm(QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation) + "/drkonqi-coredump-launcher.d"_L1);
+    return storm;
+}
+
 using ArgumentsPidTuple = std::tuple<QStringList, bool>;
 
 static ArgumentsPidTuple metadataArguments(const Coredump &dump, const QString &metadataPath)
@@ -158,6 +166,21 @@ static bool tryDrkonqi(const Coredump &dump)
         return false;
     }
 
+    if (crashStorm().coalesce(dump)) {
+        // Part of a crash storm, the drkonqi of its group covers it.
+        qWarning() << "Another crash like" << dump.exe << dump.pid << "was handled just now, not invoking DrKonqi again";
+        return true;
+    }
+    // Launchers wait here during a storm, until one of the running drkonqis is done.
+    constexpr auto slotTimeout = 10min;
+    const auto slot = crashStorm().acquireSlot(slotTimeout);
+    if (!slot) {
+        qWarning() << "Too many DrKonqis running for too long, not invoking DrKonqi for" << dump.exe << dump.pid;
+        // the next crash of its group mustn't be coalesced into this one
+        crashStorm().release(dump);
+        return true;
+    }
+
     // Append Coredump data. This allow us to not have to talk to journald again on the drkonqi side.
     metadata.beginGroup(QStringLiteral("Journal"));
     for (auto it = dump.m_rawData.cbegin(); it != dump.m_rawData.cend(); ++it) {
@@ -218,9 +241,14 @@ static void onNewDump(const Coredump &dump)
         }
         auto notifier = qobject_cast<DumpTruckInterface *>(loader.instance());
         Q_ASSERT(notifier);
+        if (crashStorm().coalesce(dump)) {
+            qWarning() << "Another crash like" << dump.exe << dump.pid << "was handled just now, not notifying again";
+            return;
+        }
         if (notifier->handle(dump)) {
             return;
         }
+        crashStorm().release(dump);
     }
 
     qWarning() << "Nothing handled the dump :O";
@@ -243,7 +271,7 @@ int main(int argc, char **argv)
     //
     // Since we don't really need to do anything fancy we'll simply poll on our own instead of relying on QLS.
 
-    QByteArray json;
+    QByteArray frame;
     QByteArray segment;
     segment.resize(Socket::DatagramSize);
     while (true) {
@@ -271,15 +299,13 @@ int main(int argc, char **argv)
             if (size == 0 && poll.revents & POLLHUP) {
                 break; // zero read + POLLHUP = EOS says the manpage
             }
-            json.append(segment.data(), size);
+            frame.append(segment.data(), size);
         }
     }
     close(SD_LISTEN_FDS_START);
 
-    QJsonParseError error{};
-    const QJsonDocument document = QJsonDocument::fromJson(json, &error);
-    if (error.error != QJsonParseError::NoError) {
-        qWarning() << "json parse error" << error.errorString();
+    const std::optional<Coredump::EntriesHash> entries = Protocol::decode(frame);
+    if (!entries) {
         return 1;
     }
 
@@ -291,7 +317,7 @@ int main(int argc, char **argv)
     unsetenv("LISTEN_PID");
     unsetenv("MANAGERPID");
 
-    onNewDump(Coredump(document));
+    onNewDump(Coredump(QByteArray() /* not from journal, has no cursor */, *entries));
 
     return 0;
 }
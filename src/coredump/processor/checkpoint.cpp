@@ -0,0 +1,60 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+*/
+
+#include "checkpoint.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+namespace Checkpoint
+{
+QByteArray read(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly)) {
+        return {};
+    }
+    return file.readAll().trimmed();
+}
+
+void write(const QString &path, const QByteArray &cursor)
+{
+    QDir().mkpath(QFileInfo(path).path());
+    QSaveFile file(path);
+    if (!file.open(QFile::WriteOnly) || file.write(cursor) != cursor.size() || !file.commit()) {
+        qWarning() << "Failed to write checkpoint" << path << file.errorString();
+    }
+}
+
+quint64 Tracker::add(const QByteArray &cursor)
+{
+    m_dumps.insert(m_nextTicket, {cursor, State::Pending});
+    return m_nextTicket++;
+}
+
+void Tracker::forwarded(quint64 ticket)
+{
+    m_dumps[ticket].state = State::Forwarded;
+}
+
+void Tracker::dropped(quint64 ticket)
+{
+    m_dumps[ticket].state = State::Dropped;
+}
+
+QByteArray Tracker::advance()
+{
+    QByteArray cursor;
+    for (auto it = m_dumps.begin(); it != m_dumps.end() && it->state != State::Pending; it = m_dumps.erase(it)) {
+        if (it->state == State::Forwarded) {
+            cursor = it->cursor;
+        }
+    }
+    return cursor;
+}
+} // namespace Checkpoint
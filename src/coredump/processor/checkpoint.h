@@ -0,0 +1,45 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QMap>
+#include <QString>
+
+// The journal cursor of the last entry a run dealt with, so the next run can resume after it.
+namespace Checkpoint
+{
+// Empty if there is none (yet).
+QByteArray read(const QString &path);
+void write(const QString &path, const QByteArray &cursor);
+
+// For dumps that are dealt with out of journal order, e.g. when they are held back by a rate limit. The checkpoint
+// only moves on to a dump that was forwarded, and only once all dumps before it were dealt with.
+class Tracker
+{
+public:
+    // A dump was taken from the journal, returns the ticket to report on it with.
+    quint64 add(const QByteArray &cursor);
+    void forwarded(quint64 ticket);
+    // Given up on (e.g. dropped), the dump no longer holds the checkpoint back but doesn't move it either.
+    void dropped(quint64 ticket);
+    // The cursor to checkpoint, empty when the checkpoint didn't move since the last call.
+    QByteArray advance();
+
+private:
+    enum class State {
+        Pending,
+        Forwarded,
+        Dropped,
+    };
+    struct Dump {
+        QByteArray cursor;
+        State state = State::Pending;
+    };
+    QMap<quint64, Dump> m_dumps; // by ticket, i.e. in journal order
+    quint64 m_nextTicket = 0;
+};
+} // namespace Checkpoint
@@ -0,0 +1,190 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+*/
+
+#include "dispatcher.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <systemd/sd-daemon.h>
+#include <systemd/sd-id128.h>
+#include <unistd.h>
+
+#include <coredump.h>
+#include <coredumpwatcher.h>
+
+using namespace std::chrono_literals;
+using namespace Qt::StringLiterals;
+
+namespace
+{
+constexpr auto SOCKET_PATH = "/run/drkonqi-coredump-dispatcher";
+// Dumps arriving within an interval are dispatched together.
+constexpr auto DISPATCH_INTERVAL = 1s;
+// Rate limit per user and interval, further dumps wait for the next interval.
+constexpr int MAX_DISPATCH_PER_USER = 4;
+// Beyond this a user's dumps are dropped, no one is going to look at that many crashes anyway.
+constexpr int MAX_QUEUED_PER_USER = 64;
+constexpr auto IDLE_TIMEOUT = 10min;
+// Without a checkpoint we start with the dumps a per crash processor would still be looking for,
+// see RuntimeMaxSec in drkonqi-coredump-processor@.service.
+constexpr auto RESUME_WINDOW = 5min;
+
+QString currentBootId()
+{
+    sd_id128_t id;
+    if (sd_id128_get_boot(&id) != 0) {
+        return {};
+    }
+    char string[SD_ID128_STRING_MAX];
+    return QString::fromLatin1(sd_id128_to_string(id, string));
+}
+} // namespace
+
+Dispatcher::Dispatcher(QObject *parent)
+    : QObject(parent)
+    , m_forward([](const Coredump &dump, QString &error) {
+        return Forward::toLauncher(dump, false, error);
+    })
+{
+    m_dispatchTimer.setSingleShot(true);
+    m_dispatchTimer.setInterval(DISPATCH_INTERVAL);
+    connect(&m_dispatchTimer, &QTimer::timeout, this, &Dispatcher::dispatch);
+
+    m_idleTimer.setSingleShot(true);
+    m_idleTimer.setInterval(IDLE_TIMEOUT);
+    connect(&m_idleTimer, &QTimer::timeout, this, [] {
+        qDebug() << "Idle, exiting. The socket will start us again.";
+        QCoreApplication::quit();
+    });
+}
+
+Dispatcher::~Dispatcher() = default;
+
+bool Dispatcher::start()
+{
+    if (sd_listen_fds(false) != 1) {
+        qWarning() << "Not exactly one fd passed by systemd. The dispatcher must be started by drkonqi-coredump-dispatcher.socket";
+        return false;
+    }
+    m_wakeupNotifier = std::make_unique<QSocketNotifier>(SD_LISTEN_FDS_START, QSocketNotifier::Read);
+    connect(m_wakeupNotifier.get(), &QSocketNotifier::activated, this, &Dispatcher::acceptWakeup);
+
+    auto expectedJournal = owning_ptr_call<sd_journal>(sd_journal_open, SD_JOURNAL_LOCAL_ONLY);
+    if (expectedJournal.ret != 0) {
+        qWarning() << "Failed to open journal" << strerror(-expectedJournal.ret);
+        return false;
+    }
+
+    m_watcher = std::make_unique<CoredumpWatcher>(std::move(expectedJournal.value), currentBootId(), QString());
+    connect(m_watcher.get(), &CoredumpWatcher::newDump, this, &Dispatcher::enqueue);
+    connect(m_watcher.get(), &CoredumpWatcher::error, this, &Dispatcher::error);
+
+    // RuntimeDirectory of the service, it is preserved across restarts but not reboots, same as the boot we look at.
+    const QString runtimeDirectory = qEnvironmentVariable("RUNTIME_DIRECTORY");
+    if (!runtimeDirectory.isEmpty()) {
+        m_checkpointPath = runtimeDirectory + "/cursor"_L1;
+        m_watcher->setResumeCursor(Checkpoint::read(m_checkpointPath));
+    }
+    m_watcher->setResumeTime(std::chrono::system_clock::now() - RESUME_WINDOW);
+    m_watcher->start();
+
+    m_idleTimer.start();
+    return true;
+}
+
+bool Dispatcher::wake(const QString &instance)
+{
+    const int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    sockaddr_un sa{};
+    sa.sun_family = AF_UNIX;
+    strncpy(static_cast<char *>(sa.sun_path), SOCKET_PATH, sizeof(sa.sun_path) - 1);
+    // Fails when the dispatcher isn't enabled, the socket doesn't exist then.
+    const bool connected = ::connect(fd, (sockaddr *)&sa, sizeof(sa)) == 0; // NOLINT
+    close(fd);
+    if (connected) {
+        qDebug() << "Handed" << instance << "to the dispatcher";
+    }
+    return connected;
+}
+
+void Dispatcher::acceptWakeup()
+{
+    // The connection only serves to (re)start us, the dump itself is read from the journal.
+    const int fd = accept4(SD_LISTEN_FDS_START, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (m_queues.isEmpty()) {
+        m_idleTimer.start();
+    }
+}
+
+void Dispatcher::enqueue(const Coredump &dump)
+{
+    m_idleTimer.stop();
+
+    const quint64 ticket = m_checkpoint.add(dump.m_cursor);
+    auto &queue = m_queues[dump.uid];
+    if (queue.size() >= MAX_QUEUED_PER_USER) {
+        qWarning() << "Too many crashes queued for" << dump.uid << "dropping" << dump.exe << dump.pid;
+        m_checkpoint.dropped(ticket);
+    } else {
+        queue.append({ticket, std::make_shared<const Coredump>(dump.m_cursor, dump.m_rawData)});
+    }
+
+    if (!m_dispatchTimer.isActive()) {
+        m_dispatchTimer.start();
+    }
+}
+
+void Dispatcher::dispatch()
+{
+    for (auto it = m_queues.begin(); it != m_queues.end();) {
+        auto &queue = it.value();
+        const auto count = std::min<qsizetype>(queue.size(), MAX_DISPATCH_PER_USER);
+        for (qsizetype i = 0; i < count; ++i) {
+            const Entry &entry = queue.at(i);
+            QString error;
+            const Forward::Result result = m_forward(*entry.dump, error);
+            if (result == Forward::Result::Forwarded) {
+                m_checkpoint.forwarded(entry.ticket);
+                continue;
+            }
+            if (result == Forward::Result::Failed) {
+                qWarning() << "Failed to forward dump" << entry.dump->exe << entry.dump->pid << error;
+            }
+            m_checkpoint.dropped(entry.ticket);
+        }
+        queue.remove(0, count);
+        if (queue.isEmpty()) {
+            it = m_queues.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Dumps that are still queued hold the checkpoint back, resuming past them would lose them.
+    if (const QByteArray cursor = m_checkpoint.advance(); !m_checkpointPath.isEmpty() && !cursor.isEmpty()) {
+        Checkpoint::write(m_checkpointPath, cursor);
+    }
+
+    if (m_queues.isEmpty()) {
+        m_idleTimer.start();
+    } else {
+        m_dispatchTimer.start();
+    }
+}
+
+#include "moc_dispatcher.cpp"
@@ -0,0 +1,71 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QSocketNotifier>
+#include <QTimer>
+
+#include <functional>
+#include <memory>
+
+#include <sys/types.h>
+
+#include "checkpoint.h"
+#include "forward.h"
+
+class Coredump;
+class CoredumpWatcher;
+
+// Resident alternative to running one processor per crash. Keeps a single journal context open, tails the coredumps
+// of this boot and fans them out to the launchers of their users, a limited number per user and interval so a crash
+// storm doesn't flood a session.
+//
+// Socket activated through drkonqi-coredump-dispatcher.socket: the per crash processors connect to wake it up and
+// exit right away. It exits by itself after being idle for a while.
+//
+// Dumps are forwarded on the event loop and forwarding blocks until the launcher took the whole dump (see
+// Forward::toLauncher), a launcher that is slow to read holds up the dumps of every other user meanwhile.
+class Dispatcher : public QObject
+{
+    Q_OBJECT
+    friend class CoredumpDispatcherTest;
+
+public:
+    explicit Dispatcher(QObject *parent = nullptr);
+    ~Dispatcher() override;
+
+    // Takes over the socket passed by systemd and starts tailing the journal.
+    bool start();
+
+    // For the per crash processors. True when a dispatcher is listening and will take care of the crash.
+    static bool wake(const QString &instance);
+
+Q_SIGNALS:
+    void error(const QString &msg);
+
+private:
+    struct Entry {
+        quint64 ticket; // of m_checkpoint
+        std::shared_ptr<const Coredump> dump;
+    };
+
+    void enqueue(const Coredump &dump);
+    void dispatch();
+    void acceptWakeup();
+
+    std::unique_ptr<CoredumpWatcher> m_watcher;
+    std::unique_ptr<QSocketNotifier> m_wakeupNotifier;
+    std::function<Forward::Result(const Coredump &dump, QString &error)> m_forward;
+    QHash<uid_t, QList<Entry>> m_queues;
+    QTimer m_dispatchTimer;
+    QTimer m_idleTimer;
+    Checkpoint::Tracker m_checkpoint;
+    QString m_checkpointPath;
+    Q_DISABLE_COPY_MOVE(Dispatcher)
+};
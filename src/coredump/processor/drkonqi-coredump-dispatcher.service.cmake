@@ -0,0 +1,39 @@
+# SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+# SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+[Unit]
+Description=Pass systemd-coredump journal entries to relevant users for potential DrKonqi handling
+Requires=drkonqi-coredump-dispatcher.socket
+After=drkonqi-coredump-dispatcher.socket
+
+[Service]
+ExecStart=@KDE_INSTALL_FULL_LIBEXECDIR@/drkonqi-coredump-processor --dispatcher
+# Holds the journal cursor of the last dispatched crash for when we get started again.
+RuntimeDirectory=drkonqi-coredump-dispatcher
+RuntimeDirectoryPreserve=yes
+Nice=10
+OOMScoreAdjust=500
+# Same confinement as drkonqi-coredump-processor@.service.
+NoNewPrivileges=yes
+CapabilityBoundingSet=~CAP_SYS_PTRACE CAP_SYS_ADMIN CAP_NET_ADMIN CAP_KILL CAP_SYS_CHROOT CAP_BLOCK_SUSPEND CAP_LINUX_IMMUTABLE
+SystemCallFilter=@system-service
+SystemCallFilter=~@privileged @resources
+ProtectClock=yes
+IPAddressDeny=any
+LockPersonality=yes
+MemoryDenyWriteExecute=yes
+PrivateDevices=yes
+PrivateNetwork=yes
+PrivateTmp=yes
+ProtectControlGroups=yes
+ProtectHostname=yes
+ProtectKernelModules=yes
+ProtectKernelTunables=yes
+ProtectKernelLogs=yes
+ProtectSystem=strict
+RestrictAddressFamilies=AF_UNIX
+RestrictNamespaces=yes
+RestrictRealtime=yes
+RestrictSUIDSGID=yes
+SystemCallArchitectures=native
+SystemCallErrorNumber=EPERM
@@ -0,0 +1,92 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+    SPDX-FileCopyrightText: 2019-2022 Harald Sitter <sitter@kde.org>
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+*/
+
+#include "forward.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QLocalSocket>
+#include <QScopeGuard>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <coredump.h>
+#include <protocol.h>
+#include <socket.h>
+
+using namespace Qt::StringLiterals;
+
+namespace Forward
+{
+Result toLauncher(const Coredump &dump, bool pickup, QString &error)
+{
+    // We only try to find the socket file at this point in time because we need to know the UID and on older systemd's we'll not
+    // be able to figure this out from just the instance information.
+    // When systemd 245 (Ubuntu 20.04) no longer is out in the wild we can move this into the main and get the
+    // uid from the instance.
+    // TODO: move this to main scope as per the comment above
+    const QByteArray socketPath = QByteArrayLiteral("/run/user/") + QByteArray::number(dump.uid) + QByteArrayLiteral("/drkonqi-coredump-launcher");
+    if (!QFile::exists(QString::fromUtf8(socketPath))) {
+        // This is intentionally not an error or fatal, not all users necessarily have
+        // a socket or drkonqi!
+        qWarning() << "The socket path doesn't exist @" << socketPath;
+        return Result::NoLauncher;
+    }
+
+    sockaddr_un sa{};
+    sa.sun_family = AF_UNIX;
+    // size_t is signed, ensure path is too
+    Q_ASSERT(socketPath.size() >= 0);
+    const std::make_unsigned<decltype(socketPath.size())>::type pathSize = socketPath.size();
+    if (pathSize > sizeof(sa.sun_path) /* '>' because we need an extra byte for null */) {
+        error = QStringLiteral("The socket path has too many characters:") + QString::fromLatin1(socketPath);
+        return Result::Failed;
+    }
+    strncpy(static_cast<char *>(sa.sun_path), socketPath.constData(), sizeof(sa.sun_path));
+
+    const int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        error = QString::fromLocal8Bit(strerror(errno));
+        return Result::Failed;
+    }
+    QScopeGuard closeFD([fd] {
+        close(fd);
+    });
+
+    if (::connect(fd, (sockaddr *)&sa, sizeof(sa)) < 0) { // NOLINT
+        error = QString::fromLocal8Bit(strerror(errno));
+        return Result::Failed;
+    }
+
+    // Send the raw data over the socket. This means the client side doesn't need to talk to journald again.
+    // A tad more efficient, and it makes nary a difference in code.
+    Coredump::EntriesHash entries = dump.m_rawData;
+    if (pickup) { // forward this into the launcher so it can choose to not have dump trucks handle dumps without metadata
+        entries.insert(Coredump::keyPickup(), "TRUE"_ba);
+    }
+
+    QLocalSocket s;
+    s.setSocketDescriptor(fd, QLocalSocket::ConnectedState, QLocalSocket::WriteOnly);
+    QByteArray data = Protocol::encode(entries);
+    while (!data.isEmpty()) {
+        // NB: we need to constrain the segment size to not run into QLocalSocket::DatagramTooLargeError
+        const qint64 written = s.write(data.constData(), std::min<int>(data.size(), Socket::DatagramSize));
+        if (written > 0) {
+            data = data.mid(written);
+            s.waitForBytesWritten();
+        } else if (s.state() != QLocalSocket::ConnectedState) {
+            qWarning() << "socket state unexpectedly" << s.state() << "aborting crash processing";
+            return Result::Aborted;
+        }
+    }
+    s.flush();
+    s.waitForBytesWritten();
+
+    return Result::Forwarded;
+}
+} // namespace Forward
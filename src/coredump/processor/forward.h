@@ -0,0 +1,24 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+*/
+
+#pragma once
+
+#include <QString>
+
+class Coredump;
+
+namespace Forward
+{
+enum class Result {
+    Forwarded,
+    NoLauncher, // the user has no launcher socket, not all users necessarily have drkonqi
+    Aborted, // the launcher went away while we were sending
+    Failed, // error is set
+};
+
+// Sends the dump to the drkonqi-coredump-launcher socket of the user it belongs to. Blocks until the whole dump was
+// written (waitForBytesWritten), i.e. as long as the launcher takes to read it.
+Result toLauncher(const Coredump &dump, bool pickup, QString &error);
+} // namespace Forward
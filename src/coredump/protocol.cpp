@@ -0,0 +1,104 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+*/
+
+#include "protocol.h"
+
+#include <QCborStreamReader>
+#include <QCborStreamWriter>
+#include <QDebug>
+#include <QtEndian>
+
+namespace
+{
+constexpr QByteArrayView MAGIC("DKCD");
+constexpr qsizetype HEADER_SIZE = MAGIC.size() + sizeof(quint8) + sizeof(quint32);
+
+// Byte strings may come in chunks.
+std::optional<QByteArray> readBytes(QCborStreamReader &reader)
+{
+    if (!reader.isByteArray()) {
+        return std::nullopt;
+    }
+    QByteArray bytes;
+    auto result = reader.readByteArray();
+    while (result.status == QCborStreamReader::Ok) {
+        bytes += result.data;
+        result = reader.readByteArray();
+    }
+    if (result.status == QCborStreamReader::Error) {
+        return std::nullopt;
+    }
+    return bytes;
+}
+} // namespace
+
+namespace Protocol
+{
+QByteArray encode(const Coredump::EntriesHash &entries)
+{
+    QByteArray payload;
+    QCborStreamWriter writer(&payload);
+    writer.startMap(entries.size());
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        writer.append(it.key());
+        writer.append(it.value());
+    }
+    writer.endMap();
+
+    QByteArray frame;
+    frame.reserve(HEADER_SIZE + payload.size());
+    frame.append(MAGIC);
+    frame.append(char(Version));
+    const quint32 size = qToBigEndian(quint32(payload.size()));
+    frame.append(reinterpret_cast<const char *>(&size), sizeof(size));
+    frame.append(payload);
+    return frame;
+}
+
+std::optional<Coredump::EntriesHash> decode(const QByteArray &frame)
+{
+    if (frame.size() < HEADER_SIZE || !frame.startsWith(MAGIC)) {
+        qWarning() << "Not a coredump frame";
+        return std::nullopt;
+    }
+    const auto version = quint8(frame.at(MAGIC.size()));
+    if (version != Version) {
+        qWarning() << "Unsupported coredump frame version" << version;
+        return std::nullopt;
+    }
+    const auto size = qFromBigEndian<quint32>(frame.constData() + MAGIC.size() + sizeof(quint8));
+    if (frame.size() - HEADER_SIZE != qsizetype(size)) {
+        qWarning() << "Coredump frame has" << frame.size() - HEADER_SIZE << "bytes of payload, expected" << size;
+        return std::nullopt;
+    }
+
+    QCborStreamReader reader(frame.constData() + HEADER_SIZE, size);
+    if (!reader.isMap()) {
+        qWarning() << "Coredump frame payload isn't a map";
+        return std::nullopt;
+    }
+    Coredump::EntriesHash entries;
+    if (reader.isLengthKnown()) {
+        entries.reserve(qsizetype(reader.length()));
+    }
+    if (!reader.enterContainer()) {
+        return std::nullopt;
+    }
+    while (reader.hasNext()) {
+        const auto key = readBytes(reader);
+        const auto value = key ? readBytes(reader) : std::nullopt;
+        if (!value) {
+            qWarning() << "Malformed coredump frame entry" << reader.lastError().toString();
+            return std::nullopt;
+        }
+        entries.insert(*key, *value);
+    }
+    if (reader.lastError() != QCborError::NoError || !reader.leaveContainer()) {
+        qWarning() << "Malformed coredump frame" << reader.lastError().toString();
+        return std::nullopt;
+    }
+    return entries;
+}
+} // namespace Protocol
@@ -0,0 +1,27 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+*/
+
+#pragma once
+
+#include <optional>
+
+#include <QByteArray>
+
+#include "coredump.h"
+
+// What drkonqi-coredump-processor sends to drkonqi-coredump-launcher. A frame is a fixed header followed by the payload:
+//
+//   magic "DKCD" | version (1 byte) | payload size (4 bytes, big endian) | payload
+//
+// The version 1 payload is a CBOR map of journal field names to values. Both are byte strings, so journal data goes
+// through verbatim, without escaping or encoding.
+namespace Protocol
+{
+constexpr quint8 Version = 1;
+
+QByteArray encode(const Coredump::EntriesHash &entries);
+// nullopt when the frame is malformed or of a version we don't understand.
+std::optional<Coredump::EntriesHash> decode(const QByteArray &frame);
+} // namespace Protocol
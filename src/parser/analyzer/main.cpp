@@ -0,0 +1,274 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Rates stored backtraces offline. Reads backtrace text files (from directories, tarballs or single files), runs
+// them through BacktraceParser in parallel and writes one JSON object per file to stdout, in input order.
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QFuture>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaEnum>
+#include <QQueue>
+#include <QThreadPool>
+#include <QtConcurrentRun>
+
+#ifdef HAVE_KARCHIVE
+#include <KTar>
+#endif
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+
+#include "../backtraceparsergdb.h"
+#include "../symboltable.h"
+
+namespace
+{
+// Feeds a text to a BacktraceParser the same way BacktraceGenerator feeds debugger output.
+class TextBacktraceGenerator : public QObject
+{
+    Q_OBJECT
+public:
+    using QObject::QObject;
+
+    void sendText(const QString &text)
+    {
+        Q_EMIT starting();
+        qsizetype start = 0;
+        while (start < text.size()) {
+            qsizetype end = text.indexOf(QLatin1Char('\n'), start);
+            if (end < 0) {
+                Q_EMIT newLine(text.sliced(start) + QLatin1Char('\n'));
+                break;
+            }
+            Q_EMIT newLine(text.sliced(start, end - start + 1));
+            start = end + 1;
+        }
+        // mark the end of the backtrace for the parser
+        Q_EMIT newLine(QString());
+    }
+
+Q_SIGNALS:
+    void starting();
+    void newLine(const QString &line);
+};
+
+QByteArray toJsonLine(const QJsonObject &object)
+{
+    return QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n';
+}
+
+QByteArray errorLine(const QString &name, const QString &error)
+{
+    return toJsonLine({{QStringLiteral("file"), name}, {QStringLiteral("error"), error}});
+}
+
+struct Options {
+    QString debugger;
+    bool bounded = false;
+};
+
+QByteArray analyzeText(const QString &name, const QString &text, const Options &options)
+{
+    // Everything lives in the calling (pool) thread, the parser only shares immutable or internally locked data.
+    // The names of the file are forgotten with it, otherwise the table grows with the corpus.
+    SymbolTable::Session symbols;
+    TextBacktraceGenerator generator;
+    std::unique_ptr<BacktraceParser> parser(BacktraceParser::newParser(options.debugger));
+    if (options.bounded) {
+        parser->setStreamingLimits(BacktraceParser::StreamingLimits());
+    }
+    if (auto gdbParser = qobject_cast<BacktraceParserGdb *>(parser.get())) {
+        gdbParser->setThreadPool(nullptr); // files are parsed in parallel already
+    }
+    parser->connectToGenerator(&generator);
+    generator.sendText(text);
+
+    const QMetaEnum usefulness = QMetaEnum::fromType<BacktraceParser::Usefulness>();
+    return toJsonLine({
+        {QStringLiteral("file"), name},
+        {QStringLiteral("usefulness"), QString::fromLatin1(usefulness.valueToKey(parser->backtraceUsefulness()))},
+        {QStringLiteral("simplifiedBacktrace"), parser->simplifiedBacktrace()},
+        {QStringLiteral("firstValidFunctions"), QJsonArray::fromStringList(parser->firstValidFunctions())},
+        {QStringLiteral("librariesWithMissingDebugSymbols"), QJsonArray::fromStringList(parser->librariesWithMissingDebugSymbols())},
+        {QStringLiteral("compositorCrashed"), parser->hasCompositorCrashed()},
+    });
+}
+
+QByteArray analyzeFile(const QString &path, const Options &options)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return errorLine(path, file.errorString());
+    }
+    return analyzeText(path, QString::fromUtf8(file.readAll()), options);
+}
+
+bool isTarball(const QString &path)
+{
+    static const QStringList suffixes{
+        QStringLiteral(".tar"),
+        QStringLiteral(".tar.gz"),
+        QStringLiteral(".tgz"),
+        QStringLiteral(".tar.bz2"),
+        QStringLiteral(".tar.xz"),
+        QStringLiteral(".tar.zst"),
+    };
+    return std::any_of(suffixes.cbegin(), suffixes.cend(), [&path](const QString &suffix) {
+        return path.endsWith(suffix);
+    });
+}
+
+// Runs the analyses on the global thread pool and prints their results in submission order. The number of pending
+// results is bounded so that neither the output nor (for tarballs) the read file contents pile up in memory.
+class Scheduler
+{
+public:
+    explicit Scheduler(int maxPending)
+        : m_maxPending(maxPending)
+    {
+    }
+
+    ~Scheduler()
+    {
+        while (!m_pending.isEmpty()) {
+            writeFirst();
+        }
+    }
+
+    void schedule(const QFuture<QByteArray> &future)
+    {
+        m_pending.enqueue(future);
+        while (m_pending.size() > m_maxPending) {
+            writeFirst();
+        }
+    }
+
+private:
+    void writeFirst()
+    {
+        const QByteArray line = m_pending.dequeue().result();
+        std::cout.write(line.constData(), line.size());
+        std::cout.flush();
+    }
+
+    const int m_maxPending;
+    QQueue<QFuture<QByteArray>> m_pending;
+};
+
+#ifdef HAVE_KARCHIVE
+void scheduleArchiveDirectory(Scheduler &scheduler, const KArchiveDirectory *directory, const QString &prefix, const Options &options)
+{
+    const QStringList entries = directory->entries();
+    for (const QString &entryName : entries) {
+        const KArchiveEntry *entry = directory->entry(entryName);
+        const QString name = prefix + QLatin1Char('/') + entryName;
+        if (entry->isDirectory()) {
+            scheduleArchiveDirectory(scheduler, static_cast<const KArchiveDirectory *>(entry), name, options);
+        } else if (entry->isFile()) {
+            // KTar is not thread-safe, extract here and only parse in the pool
+            const QString text = QString::fromUtf8(static_cast<const KArchiveFile *>(entry)->data());
+            scheduler.schedule(QtConcurrent::run(analyzeText, name, text, options));
+        }
+    }
+}
+#endif
+
+bool scheduleInput(Scheduler &scheduler, const QString &path, const Options &options)
+{
+    const QFileInfo info(path);
+    if (!info.exists()) {
+        std::cerr << "The specified input does not exist: " << qPrintable(path) << std::endl;
+        return false;
+    }
+
+    if (info.isDir()) {
+        QDirIterator it(path, QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            scheduler.schedule(QtConcurrent::run(analyzeFile, it.next(), options));
+        }
+        return true;
+    }
+
+    if (isTarball(path)) {
+#ifdef HAVE_KARCHIVE
+        KTar tar(path);
+        if (!tar.open(QIODevice::ReadOnly)) {
+            std::cerr << "Failed to open " << qPrintable(path) << ": " << qPrintable(tar.errorString()) << std::endl;
+            return false;
+        }
+        scheduleArchiveDirectory(scheduler, tar.directory(), path, options);
+        return true;
+#else
+        std::cerr << "Cannot read " << qPrintable(path) << ": built without tarball support (KArchive)" << std::endl;
+        return false;
+#endif
+    }
+
+    scheduler.schedule(QtConcurrent::run(analyzeFile, path, options));
+    return true;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("drkonqi-backtrace-analyzer"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Rates backtraces and prints the results as JSON lines."));
+    parser.addHelpOption();
+    const QCommandLineOption debuggerOption(QStringLiteral("debugger"),
+                                            QStringLiteral("The debugger that generated the backtraces (gdb, lldb, cdb, kdbgwin)."),
+                                            QStringLiteral("name"),
+                                            QStringLiteral("gdb"));
+    parser.addOption(debuggerOption);
+    const QCommandLineOption jobsOption({QStringLiteral("j"), QStringLiteral("jobs")},
+                                        QStringLiteral("Number of backtraces to parse in parallel (default: number of cores)."),
+                                        QStringLiteral("count"));
+    parser.addOption(jobsOption);
+    const QCommandLineOption boundedOption(QStringLiteral("bounded"),
+                                           QStringLiteral("Bound the memory used per backtrace, collapsing deep recursions (streaming mode)."));
+    parser.addOption(boundedOption);
+    parser.addPositionalArgument(QStringLiteral("inputs"),
+                                 QStringLiteral("Backtrace files, directories (searched recursively) or tarballs."),
+                                 QStringLiteral("inputs..."));
+    parser.process(app);
+
+    const QStringList inputs = parser.positionalArguments();
+    if (inputs.isEmpty()) {
+        parser.showHelp(1);
+    }
+
+    if (parser.isSet(jobsOption)) {
+        bool ok = false;
+        const int jobs = parser.value(jobsOption).toInt(&ok);
+        if (!ok || jobs < 1) {
+            std::cerr << "Invalid number of jobs: " << qPrintable(parser.value(jobsOption)) << std::endl;
+            return 1;
+        }
+        QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+    }
+
+    const Options options{parser.value(debuggerOption), parser.isSet(boundedOption)};
+    bool ok = true;
+    {
+        Scheduler scheduler(QThreadPool::globalInstance()->maxThreadCount() * 4);
+        for (const QString &input : inputs) {
+            ok = scheduleInput(scheduler, input, options) && ok;
+        }
+    }
+    return ok ? 0 : 1;
+}
+
+#include "main.moc"
@@ -8,6 +8,9 @@
 
 #include <QSharedData>
 #include <QString>
+#include <QStringView>
+
+#include "symboltable.h"
 
 class BacktraceLine
 {
@@ -39,6 +42,42 @@ public:
 
     static const LineRating BestRating = Good;
 
+    /*! Append-only text storage for the lines of one trace. Lines don't own copies of their text, they refer
+     * to a range of the buffer by offset and length, so appending (and thus reallocating) doesn't invalidate them.
+     * Strings are only constructed when a QString accessor is called.
+     */
+    class Buffer : public QSharedData
+    {
+    public:
+        Buffer() = default;
+        explicit Buffer(const QString &text)
+            : m_text(text)
+        {
+        }
+
+        /*! Appends text and returns its offset. */
+        qsizetype append(QStringView text)
+        {
+            const qsizetype offset = m_text.size();
+            m_text.append(text);
+            return offset;
+        }
+
+        QStringView view(qsizetype offset, qsizetype length) const
+        {
+            return QStringView(m_text).sliced(offset, length);
+        }
+
+        const QString &text() const
+        {
+            return m_text;
+        }
+
+    private:
+        QString m_text;
+    };
+    using BufferPtr = QExplicitlySharedDataPointer<Buffer>;
+
     BacktraceLine()
         : d(new Data)
     {
@@ -46,7 +85,11 @@ public:
 
     QString toString() const
     {
-        return d->m_line;
+        return lineView().toString();
+    }
+    QStringView lineView() const
+    {
+        return d->view(d->m_line);
     }
     LineType type() const
     {
@@ -63,18 +106,51 @@ public:
     }
     QString functionName() const
     {
-        return d->m_functionName;
+        return functionNameView().toString();
+    }
+    QStringView functionNameView() const
+    {
+        return d->m_functionName.isNull() ? d->m_functionNameFallback : d->view(d->m_functionName);
+    }
+    /*! The interned functionName(), lines with equal function names have equal ids. */
+    SymbolTable::Id functionId() const
+    {
+        return d->m_functionId;
     }
     QString fileName() const
     {
-        return d->m_file;
+        return fileNameView().toString();
+    }
+    QStringView fileNameView() const
+    {
+        return d->view(d->m_file);
     }
     QString libraryName() const
     {
-        return d->m_library;
+        return libraryNameView().toString();
+    }
+    QStringView libraryNameView() const
+    {
+        return d->view(d->m_library);
+    }
+    /*! The interned libraryName(), lines with equal library names have equal ids. */
+    SymbolTable::Id libraryId() const
+    {
+        return d->m_libraryId;
     }
 
 protected:
+    // A range in the buffer, a negative length denotes a null string.
+    struct Span {
+        qsizetype offset = 0;
+        qsizetype length = -1;
+
+        bool isNull() const
+        {
+            return length < 0;
+        }
+    };
+
     class Data : public QSharedData
     {
     public:
@@ -85,14 +161,62 @@ protected:
         {
         }
 
-        QString m_line;
+        QStringView view(const Span &span) const
+        {
+            return span.isNull() ? QStringView() : m_buffer->view(span.offset, span.length);
+        }
+
+        // Returns the span of part, which must be a view into the text of this line (or empty).
+        Span spanOf(QStringView part) const
+        {
+            if (part.isEmpty()) {
+                return {m_line.offset, 0};
+            }
+            return {m_line.offset + (part.data() - view(m_line).data()), part.size()};
+        }
+
+        BufferPtr m_buffer;
+        Span m_line;
         LineType m_type;
         LineRating m_rating;
         int m_stackFrameNumber;
-        QString m_functionName;
-        QString m_file;
-        QString m_library;
+        Span m_functionName;
+        QStringView m_functionNameFallback; // returned for a null m_functionName, must point to static data
+        SymbolTable::Id m_functionId = SymbolTable::EmptyId;
+        Span m_file;
+        Span m_library;
+        SymbolTable::Id m_libraryId = SymbolTable::EmptyId;
     };
+
+    /*! Makes this line refer to the given range of a (shared) trace buffer. */
+    void setLine(const BufferPtr &buffer, qsizetype offset, qsizetype length)
+    {
+        d->m_buffer = buffer;
+        d->m_line = {offset, length};
+    }
+
+    /*! Makes this line refer to a private buffer containing just line. */
+    void setLine(const QString &line)
+    {
+        setLine(BufferPtr(new Buffer(line)), 0, line.size());
+    }
+
+    // The setters take views into the text of this line (see Data::spanOf).
+    void setFunctionName(QStringView name)
+    {
+        d->m_functionName = d->spanOf(name);
+        d->m_functionId = SymbolTable::intern(name);
+    }
+    void setFileName(QStringView name)
+    {
+        d->m_file = d->spanOf(name);
+    }
+    void setLibraryName(QStringView name)
+    {
+        d->m_library = d->spanOf(name);
+        d->m_libraryId = SymbolTable::intern(name);
+    }
+
     QExplicitlySharedDataPointer<Data> d;
 };
 
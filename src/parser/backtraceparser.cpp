@@ -11,9 +11,9 @@
 #include "backtraceparserlldb.h"
 #include "backtraceparsernull.h"
 #include "drkonqi_parser_debug.h"
+#include "framerules.h"
 
 #include <QMetaEnum>
-#include <QRegularExpression>
 
 // factory
 BacktraceParser *BacktraceParser::newParser(const QString &debuggerName, QObject *parent)
@@ -55,7 +55,7 @@ QString BacktraceParser::parsedBacktrace() const
     QString result;
     if (d) {
         for (QList<BacktraceLine>::const_iterator i = d->m_linesList.constBegin(), total = d->m_linesList.constEnd(); i != total; ++i) {
-            result += i->toString();
+            result += i->lineView();
         }
     }
     return result;
@@ -67,12 +67,17 @@ QList<BacktraceLine> BacktraceParser::parsedBacktraceLines() const
     return d ? d->m_linesList : QList<BacktraceLine>();
 }
 
+StructuredBacktrace BacktraceParser::structuredBacktrace() const
+{
+    return StructuredBacktrace::fromLines(parsedBacktraceLines());
+}
+
 QString BacktraceParser::simplifiedBacktrace() const
 {
     Q_D(const BacktraceParser);
 
-    // if there is no cached usefulness, the data calculation function has not run yet.
-    if (d && d->m_usefulness == InvalidUsefulness) {
+    // if there is no cached usefulness (or lines arrived since), the data calculation function has to run.
+    if (d && d->ratingDataIsStale()) {
         const_cast<BacktraceParser *>(this)->calculateRatingData();
     }
 
@@ -84,8 +89,8 @@ BacktraceParser::Usefulness BacktraceParser::backtraceUsefulness() const
 {
     Q_D(const BacktraceParser);
 
-    // if there is no cached usefulness, the data calculation function has not run yet.
-    if (d && d->m_usefulness == InvalidUsefulness) {
+    // if there is no cached usefulness (or lines arrived since), the data calculation function has to run.
+    if (d && d->ratingDataIsStale()) {
         const_cast<BacktraceParser *>(this)->calculateRatingData();
     }
 
@@ -98,8 +103,8 @@ QStringList BacktraceParser::firstValidFunctions() const
 {
     Q_D(const BacktraceParser);
 
-    // if there is no cached usefulness, the data calculation function has not run yet.
-    if (d && d->m_usefulness == InvalidUsefulness) {
+    // if there is no cached usefulness (or lines arrived since), the data calculation function has to run.
+    if (d && d->ratingDataIsStale()) {
         const_cast<BacktraceParser *>(this)->calculateRatingData();
     }
 
@@ -111,8 +116,8 @@ QStringList BacktraceParser::librariesWithMissingDebugSymbols() const
 {
     Q_D(const BacktraceParser);
 
-    // if there is no cached usefulness, the data calculation function has not run yet.
-    if (d && d->m_usefulness == InvalidUsefulness) {
+    // if there is no cached usefulness (or lines arrived since), the data calculation function has to run.
+    if (d && d->ratingDataIsStale()) {
         const_cast<BacktraceParser *>(this)->calculateRatingData();
     }
 
@@ -124,8 +129,8 @@ bool BacktraceParser::hasCompositorCrashed() const
 {
     Q_D(const BacktraceParser);
 
-    // if there is no cached usefulness, the data calculation function has not run yet.
-    if (d && d->m_usefulness == InvalidUsefulness) {
+    // if there is no cached usefulness (or lines arrived since), the data calculation function has to run.
+    if (d && d->ratingDataIsStale()) {
         const_cast<BacktraceParser *>(this)->calculateRatingData();
     }
 
@@ -138,6 +143,7 @@ void BacktraceParser::resetState()
     // reset the state of the parser by getting a new instance of Private
     delete d_ptr;
     d_ptr = constructPrivate();
+    d_ptr->setStreamingLimits(m_streamingLimits);
 }
 
 BacktraceParserPrivate *BacktraceParser::constructPrivate() const
@@ -145,133 +151,42 @@ BacktraceParserPrivate *BacktraceParser::constructPrivate() const
     return new BacktraceParserPrivate;
 }
 
+// The function name based checks only make sense for lines that have a function name
+static bool hasFunctionName(const BacktraceLine &line)
+{
+    return line.rating() != BacktraceLine::MissingEverything && line.rating() != BacktraceLine::MissingFunction;
+}
+
 /* This function returns true if the given stack frame line is the base of the backtrace
    and thus the parser should not rate any frames below that one. */
-static bool lineIsStackBase(const BacktraceLine &line)
+static bool lineIsStackBase(const BacktraceLine &line, FrameRules::Categories categories)
 {
-    // optimization. if there is no function name, do not bother to check it
-    if (line.rating() == BacktraceLine::MissingEverything || line.rating() == BacktraceLine::MissingFunction)
-        return false;
-
-    // "start_thread" is the base frame for all threads except the main thread, FIXME "start_thread"
-    // probably works only on linux
-    // main() or kdemain() is the base for the main thread
-    if (line.functionName() == QLatin1String("start_thread") || line.functionName() == QLatin1String("main")
-        || line.functionName() == QLatin1String("kdemain")) {
-        return true;
-    }
-
-    // HACK for better rating. we ignore all stack frames below any function that matches
-    // the following regular expression. The functions that match this expression are usually
-    //"QApplicationPrivate::notify_helper", "QApplication::notify" and similar, which
-    // are used to send any kind of event to the Qt application. All stack frames below this,
-    // with or without debug symbols, are useless to KDE developers, so we ignore them.
-    const QRegularExpression re(QRegularExpression::anchoredPattern(QStringLiteral("(Q|K)(Core)?Application(Private)?::notify.*")));
-    if (re.match(line.functionName()).hasMatch()) {
-        return true;
-    }
-
-    // attempt to recognize crashes that happen after main has returned (bug 200993)
-    if (line.functionName() == QLatin1String("~KCleanUpGlobalStatic") || line.functionName() == QLatin1String("~QGlobalStatic")
-        || line.functionName() == QLatin1String("exit") || line.functionName() == QLatin1String("*__GI_exit"))
-        return true;
-
-    return false;
+    return hasFunctionName(line) && categories.testFlag(FrameRules::StackBase);
 }
 
 /* This function returns true if the given stack frame line is the top of the bactrace
    and thus the parser should not rate any frames above that one. This is used to avoid
    rating the stack frames of abort(), assert(), Q_ASSERT() and qCCritical(DRKONQI_PARSER_LOG) */
-static bool lineIsStackTop(const BacktraceLine &line)
+static bool lineIsStackTop(const BacktraceLine &line, FrameRules::Categories categories)
 {
-    // optimization. if there is no function name, do not bother to check it
-    if (line.rating() == BacktraceLine::MissingEverything || line.rating() == BacktraceLine::MissingFunction)
-        return false;
-
-    if (line.functionName().startsWith(QLatin1String("qt_assert")) // qt_assert and qt_assert_x
-        || line.functionName() == QLatin1String("qFatal") || line.functionName() == QLatin1String("abort")
-        || line.functionName() == QLatin1String("*__GI_abort") || line.functionName() == QLatin1String("*__GI___assert_fail"))
-        return true;
-
-    return false;
+    return hasFunctionName(line) && categories.testFlag(FrameRules::StackTop);
 }
 
 /* This function returns true if the given stack frame line should be ignored from rating
    for some reason. Currently it ignores all libc/libstdc++/libpthread functions. */
-static bool lineShouldBeIgnored(const BacktraceLine &line)
+static bool lineShouldBeIgnored(FrameRules::Categories categories)
 {
-    if (line.libraryName().contains(QLatin1String("libc.so")) || line.libraryName().contains(QLatin1String("libstdc++.so"))
-        || line.functionName().startsWith(QLatin1String("*__GI_")) // glibc2.9 uses *__GI_ as prefix
-        || line.libraryName().contains(QLatin1String("libpthread.so")) || line.libraryName().contains(QLatin1String("libglib-2.0.so"))
-        || line.functionName() == QLatin1String("__libc_start_main") // below main on apps without symbols
-        || line.functionName() == QLatin1String("_start") // below main on apps without symbols
-#ifdef Q_OS_MACOS
-        || (line.libraryName().startsWith(QLatin1String("libsystem_")) && line.libraryName().endsWith(QLatin1String(".dylib")))
-        || line.libraryName().contains(QLatin1String("Foundation`"))
-#endif
-        || line.libraryName().contains(QLatin1String("ntdll.dll")) || line.libraryName().contains(QLatin1String("kernel32.dll"))
-        || line.functionName().contains(QLatin1String("_tmain")) || line.functionName() == QLatin1String("WinMain")) {
-        return true;
-    }
-
-    return false;
+    return categories.testFlag(FrameRules::Ignored);
 }
 
-static bool isFunctionUseful(const BacktraceLine &line)
+static bool isFunctionUseful(const BacktraceLine &line, FrameRules::Categories categories)
 {
-    // We need the function name
-    if (line.rating() == BacktraceLine::MissingEverything || line.rating() == BacktraceLine::MissingFunction) {
-        return false;
-    }
-
-    // Misc ignores
-    if (line.functionName() == QLatin1String("__kernel_vsyscall") || line.functionName() == QLatin1String("raise")
-        || line.functionName() == QLatin1String("abort") || line.functionName() == QLatin1String("__libc_message")
-        || line.functionName() == QLatin1String("thr_kill") /* *BSD */) {
-        return false;
-    }
-
-    // Ignore core Qt functions
-    //(QObject can be useful in some cases)
-    if (line.functionName().startsWith(QLatin1String("QBasicAtomicInt::")) || line.functionName().startsWith(QLatin1String("QBasicAtomicPointer::"))
-        || line.functionName().startsWith(QLatin1String("QAtomicInt::")) || line.functionName().startsWith(QLatin1String("QAtomicPointer::"))
-        || line.functionName().startsWith(QLatin1String("QMetaObject::")) || line.functionName().startsWith(QLatin1String("QPointer::"))
-        || line.functionName().startsWith(QLatin1String("QWeakPointer::")) || line.functionName().startsWith(QLatin1String("QSharedPointer::"))
-        || line.functionName().startsWith(QLatin1String("QScopedPointer::")) || line.functionName().startsWith(QLatin1String("QMetaCallEvent::"))) {
-        return false;
-    }
-
-    // Ignore core Qt containers misc functions
-    if (line.functionName().endsWith(QLatin1String("detach")) || line.functionName().endsWith(QLatin1String("detach_helper"))
-        || line.functionName().endsWith(QLatin1String("node_create")) || line.functionName().endsWith(QLatin1String("deref"))
-        || line.functionName().endsWith(QLatin1String("ref")) || line.functionName().endsWith(QLatin1String("node_copy"))
-        || line.functionName().endsWith(QLatin1String("d_func"))) {
-        return false;
-    }
-
-    // Misc Qt stuff
-    if (line.functionName() == QLatin1String("qt_message_output") || line.functionName() == QLatin1String("qt_message")
-        || line.functionName() == QLatin1String("qFatal") || line.functionName().startsWith(QLatin1String("qGetPtrHelper"))
-        || line.functionName().startsWith(QLatin1String("qt_meta_"))) {
-        return false;
-    }
-
-    return true;
+    return hasFunctionName(line) && !categories.testFlag(FrameRules::NotUseful);
 }
 
-static bool isFunctionUsefulForSearch(const BacktraceLine &line)
+static bool isFunctionUsefulForSearch(FrameRules::Categories categories)
 {
-    // Ignore Qt containers (and iterators Q*Iterator)
-    if (line.functionName().startsWith(QLatin1String("QList")) || line.functionName().startsWith(QLatin1String("QLinkedList"))
-        || line.functionName().startsWith(QLatin1String("QVector")) || line.functionName().startsWith(QLatin1String("QStack"))
-        || line.functionName().startsWith(QLatin1String("QQueue")) || line.functionName().startsWith(QLatin1String("QSet"))
-        || line.functionName().startsWith(QLatin1String("QMap")) || line.functionName().startsWith(QLatin1String("QMultiMap"))
-        || line.functionName().startsWith(QLatin1String("QMapData")) || line.functionName().startsWith(QLatin1String("QHash"))
-        || line.functionName().startsWith(QLatin1String("QMultiHash")) || line.functionName().startsWith(QLatin1String("QHashData"))) {
-        return false;
-    }
-
-    return true;
+    return !categories.testFlag(FrameRules::NotUsefulForSearch);
 }
 
 void BacktraceParser::calculateRatingData()
@@ -281,17 +196,28 @@ void BacktraceParser::calculateRatingData()
     uint rating = 0, bestPossibleRating = 0, counter = 0;
     bool haveSeenStackBase = false;
 
-    QListIterator<BacktraceLine> i(d->m_linesToRate);
-    i.toBack(); // start from the end of the list
+    // This runs again every time a block of frames is complete, so start over. The classification of a frame
+    // doesn't depend on its neighbours though, only the frames that arrived since the last run need classifying.
+    d->m_librariesWithMissingDebugSymbols.clear();
+    d->m_simplifiedBacktrace.clear();
+    d->m_firstUsefulFunctions.clear();
+    d->m_ratedRevision = d->m_linesToRateRevision;
+
+    const FrameRules &rules = FrameRules::instance();
+    for (qsizetype index = d->m_linesToRateCategories.size(); index < d->m_linesToRate.size(); ++index) {
+        d->m_linesToRateCategories.append(rules.classify(d->m_linesToRate.at(index)));
+    }
+    const QList<FrameRules::Categories> &categories = d->m_linesToRateCategories;
 
-    while (i.hasPrevious()) {
-        const BacktraceLine &line = i.previous();
+    for (qsizetype index = d->m_linesToRate.size() - 1; index >= 0; --index) { // start from the end of the list
+        const BacktraceLine &line = d->m_linesToRate.at(index);
+        const FrameRules::Categories lineCategories = categories.at(index);
 
-        if (!d->m_compositorCrashed && line.toString().contains(QLatin1String("The Wayland connection broke. Did the Wayland compositor die"))) {
+        if (!d->m_compositorCrashed && line.lineView().contains(QLatin1String("The Wayland connection broke. Did the Wayland compositor die"))) {
             d->m_compositorCrashed = true;
         }
 
-        if (!i.hasPrevious() && line.rating() == BacktraceLine::MissingEverything) {
+        if (index == 0 && line.rating() == BacktraceLine::MissingEverything) {
             // Under some circumstances, the very first stack frame is invalid (ex, calling a function
             // at an invalid address could result in a stack frame like "0x00000000 in ?? ()"),
             // which however does not necessarily mean that the backtrace has a missing symbol on
@@ -299,26 +225,26 @@ void BacktraceParser::calculateRatingData()
             break; // there are no more items anyway, just break the loop
         }
 
-        if (lineIsStackBase(line)) {
+        if (lineIsStackBase(line, lineCategories)) {
             rating = bestPossibleRating = counter = 0; // restart rating ignoring any previous frames
             haveSeenStackBase = true;
-        } else if (lineIsStackTop(line)) {
+        } else if (lineIsStackTop(line, lineCategories)) {
             break; // we have reached the top, no need to inspect any more frames
         }
 
-        if (lineShouldBeIgnored(line)) {
+        if (lineShouldBeIgnored(lineCategories)) {
             continue;
         }
 
         if (line.rating() == BacktraceLine::MissingFunction || line.rating() == BacktraceLine::MissingSourceFile) {
-            d->m_librariesWithMissingDebugSymbols.append(line.libraryName().trimmed());
+            d->m_librariesWithMissingDebugSymbols.append(line.libraryNameView().trimmed().toString());
         }
 
         uint multiplier = ++counter; // give weight to the first lines
         rating += static_cast<uint>(line.rating()) * multiplier;
         bestPossibleRating += static_cast<uint>(BacktraceLine::BestRating) * multiplier;
 
-        qCDebug(DRKONQI_PARSER_LOG) << line.rating() << line.toString();
+        qCDebug(DRKONQI_PARSER_LOG) << line.rating() << line.lineView();
     }
 
     // Generate a simplified backtrace
@@ -327,21 +253,21 @@ void BacktraceParser::calculateRatingData()
     //- Replaces garbage with [...]
     // At the same time, grab the first three useful functions for search queries
 
-    i.toFront(); // Reuse the list iterator
     int functionIndex = 0;
     int usefulFunctionsCount = 0;
     bool firstUsefulFound = false;
-    while (i.hasNext() && functionIndex < 5) {
-        const BacktraceLine &line = i.next();
-        if (!lineShouldBeIgnored(line) && isFunctionUseful(line)) { // Line is not garbage to use
+    for (qsizetype index = 0; index < d->m_linesToRate.size() && functionIndex < 5; ++index) {
+        const BacktraceLine &line = d->m_linesToRate.at(index);
+        const FrameRules::Categories lineCategories = categories.at(index);
+        if (!lineShouldBeIgnored(lineCategories) && isFunctionUseful(line, lineCategories)) { // Line is not garbage to use
             if (!firstUsefulFound) {
                 firstUsefulFound = true;
             }
             // Save simplified backtrace line
-            d->m_simplifiedBacktrace += line.toString();
+            d->m_simplifiedBacktrace += line.lineView();
 
             // Fetch three useful functions (only functionName) for search queries
-            if (usefulFunctionsCount < 3 && isFunctionUsefulForSearch(line) && !d->m_firstUsefulFunctions.contains(line.functionName())) {
+            if (usefulFunctionsCount < 3 && isFunctionUsefulForSearch(lineCategories) && !d->m_firstUsefulFunctions.contains(line.functionNameView())) {
                 d->m_firstUsefulFunctions.append(line.functionName());
                 usefulFunctionsCount++;
             }
@@ -392,10 +318,52 @@ QString BacktraceParser::informationLines() const
     return ret;
 }
 
-void BacktraceParser::newLineInternal(const QString &)
+void BacktraceParser::setStreamingLimits(const std::optional<StreamingLimits> &limits)
+{
+    m_streamingLimits = limits;
+}
+
+void BacktraceParser::updateRatingData()
+{
+    Q_D(BacktraceParser);
+
+    // Nothing to judge yet, e.g. the crashing thread didn't come up so far. Don't announce a premature "Useless".
+    if (d->m_linesToRate.isEmpty() || !d->ratingDataIsStale()) {
+        return;
+    }
+    recalculateRatingData();
+}
+
+void BacktraceParser::recalculateRatingData()
+{
+    Q_D(BacktraceParser);
+
+    const Usefulness oldUsefulness = d->m_usefulness;
+    const QStringList oldFunctions = d->m_firstUsefulFunctions;
+    const QStringList oldLibraries = d->m_librariesWithMissingDebugSymbols;
+    const bool oldCompositorCrashed = d->m_compositorCrashed;
+
+    calculateRatingData();
+
+    if (d->m_usefulness != oldUsefulness || d->m_firstUsefulFunctions != oldFunctions || d->m_librariesWithMissingDebugSymbols != oldLibraries
+        || d->m_compositorCrashed != oldCompositorCrashed) {
+        Q_EMIT ratingDataChanged();
+    }
+}
+
+void BacktraceParser::newLineInternal(const QString &lineStr)
 {
     Q_D(BacktraceParser);
-    d->m_usefulness = InvalidUsefulness;
+
+    // a null line marks the end of the backtrace, newLine() has seen it already
+    if (!lineStr.isNull()) {
+        return;
+    }
+    d->m_linesListWindow.finish();
+    d->m_linesToRateWindow.finish();
+    if (d->ratingDataIsStale()) {
+        recalculateRatingData();
+    }
 }
 
 #include "moc_backtraceparser.cpp"
@@ -8,10 +8,14 @@
 #define BACKTRACEPARSER_H
 
 #include "backtraceline.h"
+#include "structuredbacktrace.h"
 #include <QMetaType>
 #include <QObject>
 #include <QSet>
 #include <QStringList>
+
+#include <optional>
+
 class BacktraceParserPrivate;
 
 class BacktraceParser : public QObject
@@ -28,6 +32,15 @@ public:
     };
     Q_ENUM(Usefulness)
 
+    /*! Limits of the streaming mode, see setStreamingLimits(). */
+    struct StreamingLimits {
+        qsizetype headLines = 100; // lines kept at the beginning of every thread
+        qsizetype tailLines = 100; // lines kept at the end of every thread
+        qsizetype maxCycleLength = 16; // repetitions of cycles of up to this many frames are collapsed
+        qsizetype maxLines = 10000; // hard cap for the whole backtrace
+        qsizetype maxBytes = 4 * 1024 * 1024; // hard cap for the text of the whole backtrace
+    };
+
     static BacktraceParser *newParser(const QString &debuggerName, QObject *parent = nullptr);
     ~BacktraceParser() override;
 
@@ -44,6 +57,9 @@ public:
      */
     virtual QList<BacktraceLine> parsedBacktraceLines() const;
 
+    /*! Same as parsedBacktraceLines(), grouped into threads with their stack frames and the modules they belong to. */
+    StructuredBacktrace structuredBacktrace() const;
+
     /*! Returns a simplified version of the backtrace. This backtrace:
      * \li Starts from the first useful function
      * \li Has maximum 5 lines
@@ -69,14 +85,32 @@ public:
 
     QString informationLines() const;
 
+    /*! Bounds the memory used for pathological backtraces, e.g. infinite recursion with hundreds of thousands of
+     * frames. Of every thread only the first and the last lines are kept, consecutive repetitions of a cycle of frames
+     * are collapsed into one copy and earlier threads are thinned out when the backtrace exceeds the caps. Lines that
+     * were left out are replaced by a "[... ...]" line saying so. The rating only considers the kept frames.
+     * Takes effect when the generator (re)starts, std::nullopt (the default) keeps everything.
+     */
+    void setStreamingLimits(const std::optional<StreamingLimits> &limits);
+
+Q_SIGNALS:
+    /*! Emitted when the rating data (usefulness, first valid functions, libraries with missing debug symbols and
+     * the compositor crash state) changed. The data is updated while the backtrace is being generated, every
+     * time a block of frames (e.g. a thread) is complete, and once more when the backtrace is complete.
+     */
+    void ratingDataChanged();
+
 private Q_SLOTS:
     void resetState();
     void newLineInternal(const QString &lineStr);
 
+private:
+    void recalculateRatingData();
+
 protected Q_SLOTS:
     /*! Called every time there is a new line from the generator. Subclasses should parse
      * the line here and insert it in the m_linesList field of BacktraceParserPrivate.
-     * If the line is useful for rating as well, it should also be inserted in the m_linesToRate
+     * If the line is useful for rating as well, it should also be appended to the m_linesToRate
      * field, so that calculateRatingData() can use it.
      */
     virtual void newLine(const QString &lineStr) = 0;
@@ -94,7 +128,16 @@ protected:
      */
     virtual void calculateRatingData();
 
+    /*! Subclasses should call this when a block of frames is complete (e.g. at the start of the next thread), so
+     * that the rating data gets updated while the backtrace is still streaming in. Does nothing when no lines were
+     * added to m_linesToRate since the last update.
+     */
+    void updateRatingData();
+
     BacktraceParserPrivate *d_ptr;
+
+private:
+    std::optional<StreamingLimits> m_streamingLimits;
 };
 
 Q_DECLARE_METATYPE(BacktraceParser::Usefulness)
@@ -8,6 +8,8 @@
 #define BACKTRACEPARSER_P_H
 
 #include "backtraceparser.h"
+#include "framerules.h"
+#include "linewindow.h"
 
 class BacktraceParserPrivate
 {
@@ -15,14 +17,53 @@ public:
     BacktraceParserPrivate()
         : m_usefulness(BacktraceParser::InvalidUsefulness)
     {
+        // the classification has to follow when lines to rate are left out
+        m_linesToRateWindow.aboutToErase = [this](qsizetype from, qsizetype to) {
+            if (from < m_linesToRateCategories.size()) {
+                m_linesToRateCategories.remove(from, std::min(to, m_linesToRateCategories.size()) - from);
+            }
+        };
     }
     ~BacktraceParserPrivate()
     {
     }
+    Q_DISABLE_COPY_MOVE(BacktraceParserPrivate)
+
+    // whether calculateRatingData() needs to run (again) before the rating data can be used
+    bool ratingDataIsStale() const
+    {
+        return m_usefulness == BacktraceParser::InvalidUsefulness || m_ratedRevision != m_linesToRateRevision;
+    }
+
+    void setStreamingLimits(const std::optional<BacktraceParser::StreamingLimits> &limits)
+    {
+        m_linesListWindow.setLimits(limits);
+        m_linesToRateWindow.setLimits(limits);
+    }
+
+    // Subclasses append through these instead of to the lists directly, so that the streaming limits apply.
+    void appendLine(const BacktraceLine &line)
+    {
+        m_linesListWindow.append(line);
+    }
+    void appendLineToRate(const BacktraceLine &line)
+    {
+        m_linesToRateWindow.append(line);
+        ++m_linesToRateRevision;
+    }
 
     QStringList m_infoLines;
+    // the buffer new lines are appended to (for parsers that share a buffer between their lines)
+    BacktraceLine::BufferPtr m_buffer{new BacktraceLine::Buffer};
     QList<BacktraceLine> m_linesList;
+    LineWindow m_linesListWindow{m_linesList, true};
     QList<BacktraceLine> m_linesToRate;
+    LineWindow m_linesToRateWindow{m_linesToRate, false};
+    // FrameRules classification of m_linesToRate, filled as the lines get rated
+    QList<FrameRules::Categories> m_linesToRateCategories;
+    // counts the lines appended to m_linesToRate, and its value when the rating data was last calculated
+    quint64 m_linesToRateRevision = 0;
+    quint64 m_ratedRevision = 0;
     QStringList m_firstUsefulFunctions;
     QString m_simplifiedBacktrace;
     QStringList m_librariesWithMissingDebugSymbols;
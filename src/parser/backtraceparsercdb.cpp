@@ -20,13 +20,13 @@ BacktraceParserPrivate *BacktraceParserCdb::constructPrivate() const
 
 void BacktraceParserCdb::newLine(const QString &lineStr)
 {
-    d_ptr->m_linesList.append(BacktraceLineCdb(lineStr));
+    d_ptr->appendLine(BacktraceLineCdb(lineStr));
 }
 
 BacktraceLineCdb::BacktraceLineCdb(const QString &line)
     : BacktraceLine()
 {
-    d->m_line = line;
+    setLine(line);
     // We should do the faith jump to believe that cdb will provides useful information
     d->m_rating = Good;
 }
@@ -7,18 +7,46 @@
 #include "backtraceparser_p.h"
 #include "drkonqi_parser_debug.h"
 
-#include <QFileInfo>
+#include "gdbframetokenizer.h"
+
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QQueue>
 #include <QRegularExpression>
+#include <QThreadPool>
+#include <QtConcurrentRun>
 
 // BEGIN BacktraceLineGdb
 
+// Same as QFileInfo::completeSuffix() but without constructing a QFileInfo for every frame.
+static QStringView completeSuffixOf(QStringView path)
+{
+    const QStringView fileName = path.sliced(path.lastIndexOf(QLatin1Char('/')) + 1);
+    const qsizetype dot = fileName.indexOf(QLatin1Char('.'));
+    return dot < 0 ? QStringView() : fileName.sliced(dot + 1);
+}
+
 const QLatin1String BacktraceParserGdb::KCRASH_INFO_MESSAGE("KCRASH_INFO_MESSAGE: ");
 
 BacktraceLineGdb::BacktraceLineGdb(const QString &lineStr)
     : BacktraceLine()
 {
-    d->m_line = lineStr;
-    d->m_functionName = QLatin1String("??");
+    setLine(lineStr);
+    init();
+}
+
+BacktraceLineGdb::BacktraceLineGdb(const BufferPtr &buffer, qsizetype offset, qsizetype length)
+    : BacktraceLine()
+{
+    setLine(buffer, offset, length);
+    init();
+}
+
+void BacktraceLineGdb::init()
+{
+    static const SymbolTable::Id unknownFunctionId = SymbolTable::intern(u"??");
+    d->m_functionNameFallback = u"??";
+    d->m_functionId = unknownFunctionId;
     parse();
     if (d->m_type == StackFrame) {
         rate();
@@ -27,102 +55,80 @@ BacktraceLineGdb::BacktraceLineGdb(const QString &lineStr)
 
 void BacktraceLineGdb::parse()
 {
-    if (d->m_line == QLatin1Char('\n')) {
+    const QStringView lineStr = lineView();
+    if (lineStr == QLatin1String("\n")) {
         d->m_type = EmptyLine;
         return;
-    } else if (d->m_line == QLatin1String("[KCrash Handler]\n")) {
+    } else if (lineStr == QLatin1String("[KCrash Handler]\n")) {
         d->m_type = KCrash;
         return;
-    } else if (d->m_line.contains(QLatin1String("<signal handler called>"))) {
+    } else if (lineStr.contains(QLatin1String("<signal handler called>"))) {
         d->m_type = SignalHandlerStart;
         return;
     }
 
-    static QRegularExpression regExp;
-    // make dot "." char match new lines, to match e.g.:
+    // gdb breaks long stack frame lines into multiple ones for readability, e.g.
     // "#5  0x00007f50e99f776f in QWidget::testAttribute_helper (this=0x6e6440,\n    attribute=Qt::WA_WState_Created) at kernel/qwidget.cpp:9081\n"
-    // gdb breaks long stack frame lines into multiple ones for readability
-    regExp.setPatternOptions(QRegularExpression::DotMatchesEverythingOption);
-    regExp.setPattern(
-        QRegularExpression::anchoredPattern(QStringLiteral("#([0-9]+)" // matches the stack frame number, ex. "#0"
-                                                           "[\\s]+(?:0x[0-9a-f]+[\\s]+in[\\s]+)?" // matches " 0x0000dead in " (optionally)
-                                                           "((?:\\(anonymous namespace\\)::)?[^\\(]+)?" // matches the function name
-                                                           //(anything except left parenthesis, which is the start of the arguments section)
-                                                           // and optionally the prefix "(anonymous namespace)::"
-                                                           "(?:\\(.*\\))?" // matches the function arguments
-                                                                           //(when the app doesn't have debugging symbols)
-                                                           "[\\s]+(?:const[\\s]+)?" // matches a trailing const, if it exists
-                                                           "\\(.*\\)" // matches the arguments of the function with their values
-                                                                      //(when the app has debugging symbols)
-                                                           "([\\s]+" // beginning of optional file information
-                                                           "(from|at)[\\s]+" // matches "from " or "at "
-                                                           "(.+)" // matches the filename (source file or shared library file)
-                                                           ")?\n"))); // matches trailing newline.
-    // the )? at the end closes the parenthesis before [\\s]+(from|at) and
-    // notes that the whole expression from there is optional.
-
-    QRegularExpressionMatch match = regExp.match(d->m_line);
-    if (match.hasMatch()) {
+    // the tokenizer deals with that.
+    if (const auto frame = tokenizeGdbFrame(lineStr); frame.has_value()) {
         d->m_type = StackFrame;
-        d->m_stackFrameNumber = match.captured(1).toInt();
-        d->m_functionName = match.captured(2).trimmed();
+        d->m_stackFrameNumber = frame->frameNumber;
+        setFunctionName(frame->functionName);
 
-        if (!match.captured(3).isEmpty()) { // we have file information (stuff after from|at)
-            bool file = match.captured(4) == QLatin1String("at"); //'at' means we have a source file (likely)
+        if (frame->locationKind != GdbFrameTokens::LocationKind::None) { // we have file information (stuff after from|at)
+            bool file = frame->locationKind == GdbFrameTokens::LocationKind::At; //'at' means we have a source file (likely)
             // Gdb isn't entirely consistent here, when it uses 'from' it always refers to a library, but
             // sometimes the stack can resolve to a library even when it uses the 'at' key word.
             // This specifically seems to happen when a frame has no function name.
-            const QString path = match.captured(5);
-            const auto completeSuffix = QFileInfo(path).completeSuffix();
+            const QStringView completeSuffix = completeSuffixOf(frame->location);
             file = file && completeSuffix != QLatin1String("so") /* libf.so (so) */
                 && !completeSuffix.startsWith(QLatin1String("so.")) /* libf.so.1 (so.1) */
                 && !completeSuffix.contains(QLatin1String(".so") /* libf-1.0.so.1 (0.so.1)*/);
             if (file) {
-                d->m_file = match.captured(5);
+                setFileName(frame->location);
             } else { //'from' means we have a library
-                d->m_library = match.captured(5);
+                setLibraryName(frame->location);
             }
         }
 
-        qCDebug(DRKONQI_PARSER_LOG) << d->m_stackFrameNumber << d->m_functionName << d->m_file << d->m_library;
+        qCDebug(DRKONQI_PARSER_LOG) << d->m_stackFrameNumber << functionNameView() << fileNameView() << libraryNameView();
         return;
     }
 
-    if (d->m_line.contains(BacktraceParserGdb::KCRASH_INFO_MESSAGE)) {
-        qCDebug(DRKONQI_PARSER_LOG) << "info:" << d->m_line;
+    if (lineStr.contains(BacktraceParserGdb::KCRASH_INFO_MESSAGE)) {
+        qCDebug(DRKONQI_PARSER_LOG) << "info:" << lineStr;
         d->m_type = Info;
         return;
     }
 
-    regExp.setPatternOptions(regExp.patternOptions() & ~QRegularExpression::DotMatchesEverythingOption);
-
-    regExp.setPattern(
+    static const QRegularExpression crapExp(
         QRegularExpression::anchoredPattern(QStringLiteral(".*\\(no debugging symbols found\\).*|"
                                                            ".*\\[Thread debugging using libthread_db enabled\\].*|"
                                                            ".*\\[New .*|"
                                                            "0x[0-9a-f]+.*|"
                                                            "Current language:.*")));
-    if (regExp.match(d->m_line).hasMatch()) {
-        qCDebug(DRKONQI_PARSER_LOG) << "garbage detected:" << d->m_line;
+    if (crapExp.matchView(lineStr).hasMatch()) {
+        qCDebug(DRKONQI_PARSER_LOG) << "garbage detected:" << lineStr;
         d->m_type = Crap;
         return;
     }
 
-    regExp.setPattern(QRegularExpression::anchoredPattern(QStringLiteral("Thread [0-9]+\\s+\\(Thread [0-9a-fx]+\\s+\\(.*\\)\\):\n")));
-    if (regExp.match(d->m_line).hasMatch()) {
-        qCDebug(DRKONQI_PARSER_LOG) << "thread start detected:" << d->m_line;
+    static const QRegularExpression threadStartExp(
+        QRegularExpression::anchoredPattern(QStringLiteral("Thread [0-9]+\\s+\\(Thread [0-9a-fx]+\\s+\\(.*\\)\\):\n")));
+    if (threadStartExp.matchView(lineStr).hasMatch()) {
+        qCDebug(DRKONQI_PARSER_LOG) << "thread start detected:" << lineStr;
         d->m_type = ThreadStart;
         return;
     }
 
-    regExp.setPattern(QRegularExpression::anchoredPattern(QStringLiteral("\\[Current thread is [0-9]+ \\(.*\\)\\]\n")));
-    if (regExp.match(d->m_line).hasMatch()) {
-        qCDebug(DRKONQI_PARSER_LOG) << "thread indicator detected:" << d->m_line;
+    static const QRegularExpression threadIndicatorExp(QRegularExpression::anchoredPattern(QStringLiteral("\\[Current thread is [0-9]+ \\(.*\\)\\]\n")));
+    if (threadIndicatorExp.matchView(lineStr).hasMatch()) {
+        qCDebug(DRKONQI_PARSER_LOG) << "thread indicator detected:" << lineStr;
         d->m_type = ThreadIndicator;
         return;
     }
 
-    qCDebug(DRKONQI_PARSER_LOG) << "line" << d->m_line << "did not match";
+    qCDebug(DRKONQI_PARSER_LOG) << "line" << lineStr << "did not match";
 }
 
 void BacktraceLineGdb::rate()
@@ -130,16 +136,17 @@ void BacktraceLineGdb::rate()
     LineRating r;
 
     // for explanations, see the LineRating enum definition
-    if (!fileName().isEmpty()) {
+    const QStringView function = functionNameView();
+    if (!fileNameView().isEmpty()) {
         r = Good;
-    } else if (!libraryName().isEmpty()) {
-        if (functionName() == QLatin1String("??") || functionName().isEmpty()) {
+    } else if (!libraryNameView().isEmpty()) {
+        if (function == QLatin1String("??") || function.isEmpty()) {
             r = MissingFunction;
         } else {
             r = MissingSourceFile;
         }
     } else {
-        if (functionName() == QLatin1String("??") || functionName().isEmpty()) {
+        if (function == QLatin1String("??") || function.isEmpty()) {
             r = MissingEverything;
         } else {
             r = MissingLibrary;
@@ -153,12 +160,21 @@ void BacktraceLineGdb::rate()
 
 // BEGIN BacktraceParserGdb
 
+// Blocks are split after this many lines, so that a thread with a huge number of frames neither waits for its end to be
+// parsed nor collects all of its text in one buffer.
+static constexpr qsizetype MAX_BLOCK_LINES = 4096;
+
 class BacktraceParserGdbPrivate : public BacktraceParserPrivate
 {
 public:
     using BacktraceParserPrivate::BacktraceParserPrivate;
 
     QString m_lineInputBuffer;
+    // lines of the current block, as spans of m_buffer
+    QList<std::pair<qsizetype, qsizetype>> m_blockLines;
+    // blocks being parsed, in trace order
+    QQueue<QFuture<QList<BacktraceLineGdb>>> m_pendingBlocks;
+    // lines of the current thread before its possible KCrash frames (the thread header)
     int m_possibleKCrashStart = 0;
     int m_threadsCount = 0;
     bool m_isBelowSignalHandler = false;
@@ -167,9 +183,15 @@ public:
 
 BacktraceParserGdb::BacktraceParserGdb(QObject *parent)
     : BacktraceParser(parent)
+    , m_threadPool(QThreadPool::globalInstance())
 {
 }
 
+void BacktraceParserGdb::setThreadPool(QThreadPool *pool)
+{
+    m_threadPool = pool;
+}
+
 BacktraceParserPrivate *BacktraceParserGdb::constructPrivate() const
 {
     return new BacktraceParserGdbPrivate;
@@ -191,22 +213,111 @@ void BacktraceParserGdb::newLine(const QString &lineStr)
         parseLine(d->m_lineInputBuffer);
         d->m_lineInputBuffer = lineStr;
     }
+
+    // a null line marks the end of the backtrace
+    if (lineStr.isNull()) {
+        flushBlocks();
+    }
 }
 
 void BacktraceParserGdb::parseLine(const QString &lineStr)
 {
     Q_D(BacktraceParserGdb);
 
-    BacktraceLineGdb line(lineStr);
+    // A thread start begins a new block. This is only a cheap guess, the actual line type is determined when parsing
+    // and lines are processed in order regardless of how they were grouped.
+    if ((lineStr.startsWith(QLatin1String("Thread ")) && !d->m_blockLines.isEmpty()) || d->m_blockLines.size() >= MAX_BLOCK_LINES) {
+        dispatchBlock();
+    }
+    // the lines of a block share one buffer, see BacktraceLine::Buffer
+    d->m_blockLines.append({d->m_buffer->append(lineStr), lineStr.size()});
+
+    applyBlocks(false);
+}
+
+void BacktraceParserGdb::dispatchBlock()
+{
+    Q_D(BacktraceParserGdb);
+
+    // The buffer is handed over to the block and not touched by this thread anymore, the next block gets a new one.
+    // With streaming limits most lines get dropped again, the kept ones get their own copy of the text instead of
+    // keeping the whole buffer alive.
+    const bool ownBuffers = d->m_linesListWindow.isBounded();
+    auto parseBlock = [buffer = d->m_buffer, spans = std::exchange(d->m_blockLines, {}), ownBuffers] {
+        QList<BacktraceLineGdb> lines;
+        lines.reserve(spans.size());
+        for (const auto &[offset, length] : spans) {
+            lines.append(ownBuffers ? BacktraceLineGdb(buffer->view(offset, length).toString()) : BacktraceLineGdb(buffer, offset, length));
+        }
+        return lines;
+    };
+    d->m_buffer = BacktraceLine::BufferPtr(new BacktraceLine::Buffer);
+
+    if (m_threadPool) {
+        d->m_pendingBlocks.enqueue(QtConcurrent::run(m_threadPool, std::move(parseBlock)));
+        // Merge the block as soon as it is parsed, the getters only ever see the lines merged so far, so the rating
+        // and the text always describe the same lines.
+        auto watcher = new QFutureWatcher<QList<BacktraceLineGdb>>(this);
+        connect(watcher, &std::remove_pointer_t<decltype(watcher)>::finished, this, [this, watcher] {
+            watcher->deleteLater();
+            applyBlocks(false);
+        });
+        watcher->setFuture(d->m_pendingBlocks.last());
+        // with streaming limits, don't let parsed blocks pile up when the input arrives faster than it is parsed
+        if (ownBuffers && d->m_pendingBlocks.size() > 2 * m_threadPool->maxThreadCount()) {
+            d->m_pendingBlocks.head().waitForFinished();
+            applyBlocks(false);
+        }
+    } else {
+        applyBlocks(true);
+        const QList<BacktraceLineGdb> lines = parseBlock();
+        for (const BacktraceLineGdb &line : lines) {
+            processLine(line);
+        }
+    }
+}
+
+void BacktraceParserGdb::applyBlocks(bool wait)
+{
+    Q_D(BacktraceParserGdb);
+
+    while (!d->m_pendingBlocks.isEmpty() && (wait || d->m_pendingBlocks.head().isFinished())) {
+        const QList<BacktraceLineGdb> lines = d->m_pendingBlocks.dequeue().result();
+        for (const BacktraceLineGdb &line : lines) {
+            processLine(line);
+        }
+    }
+}
+
+void BacktraceParserGdb::flushBlocks()
+{
+    Q_D(BacktraceParserGdb);
+
+    if (!d) {
+        return;
+    }
+    if (!d->m_blockLines.isEmpty()) {
+        dispatchBlock();
+    }
+    applyBlocks(true);
+}
+
+void BacktraceParserGdb::processLine(const BacktraceLineGdb &line)
+{
+    Q_D(BacktraceParserGdb);
+
     switch (line.type()) {
     case BacktraceLine::Crap:
         break; // we don't want crap in the backtrace ;)
     case BacktraceLine::Info:
-        d->m_infoLines << line.toString().mid(KCRASH_INFO_MESSAGE.size());
+        d->m_infoLines << line.lineView().sliced(KCRASH_INFO_MESSAGE.size()).toString();
         break;
     case BacktraceLine::ThreadStart:
-        d->m_linesList.append(line);
-        d->m_possibleKCrashStart = d->m_linesList.size();
+        // the previous thread is complete, let listeners know how the backtrace looks so far
+        updateRatingData();
+        d->m_linesListWindow.startSegment();
+        d->appendLine(line);
+        d->m_possibleKCrashStart = 1;
         d->m_threadsCount++;
         // reset the state of the flags that need to be per-thread
         d->m_isBelowSignalHandler = false;
@@ -215,13 +326,13 @@ void BacktraceParserGdb::parseLine(const QString &lineStr)
     case BacktraceLine::SignalHandlerStart:
         if (!d->m_isBelowSignalHandler) {
             // replace the stack frames of KCrash with a nice message
-            d->m_linesList.erase(d->m_linesList.begin() + d->m_possibleKCrashStart, d->m_linesList.end());
-            d->m_linesList.insert(d->m_possibleKCrashStart, BacktraceLineGdb(QStringLiteral("[KCrash Handler]\n")));
+            d->m_linesListWindow.truncateSegment(d->m_possibleKCrashStart);
+            d->appendLine(BacktraceLineGdb(QStringLiteral("[KCrash Handler]\n")));
             d->m_isBelowSignalHandler = true; // next line is the first below the signal handler
         } else {
             // this is not the first time we see a crash handler frame on the same thread,
             // so we just add it to the list
-            d->m_linesList.append(line);
+            d->appendLine(line);
         }
         break;
     case BacktraceLine::StackFrame:
@@ -240,12 +351,12 @@ void BacktraceParserGdb::parseLine(const QString &lineStr)
 
         // rate the stack frame if we are below the signal handler
         if (d->m_isBelowSignalHandler) {
-            d->m_linesToRate.append(line);
+            d->appendLineToRate(line);
         }
         Q_FALLTHROUGH();
         // fall through and append the line to the list
     default:
-        d->m_linesList.append(line);
+        d->appendLine(line);
         break;
     }
 }
@@ -264,7 +375,7 @@ QString BacktraceParserGdb::parsedBacktrace() const
                 && ((*i).type() == BacktraceLine::ThreadIndicator || (*i).type() == BacktraceLine::ThreadStart || (*i).type() == BacktraceLine::EmptyLine)) {
                 continue;
             }
-            result += i->toString();
+            result += i->lineView();
         }
     }
     return result;
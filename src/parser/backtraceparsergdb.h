@@ -8,13 +8,17 @@
 
 #include "backtraceparser.h"
 class BacktraceParserGdbPrivate;
+class QThreadPool;
 
 class BacktraceLineGdb : public BacktraceLine
 {
 public:
     BacktraceLineGdb(const QString &line);
+    /*! Parses the given range of a trace buffer, the line keeps referring to the buffer instead of copying. */
+    BacktraceLineGdb(const BufferPtr &buffer, qsizetype offset, qsizetype length);
 
 private:
+    void init();
     void parse();
     void rate();
 };
@@ -30,6 +34,14 @@ public:
     QList<BacktraceLine> parsedBacktraceLines() const override;
     static const QLatin1String KCRASH_INFO_MESSAGE;
 
+    /*! Thread blocks ("Thread N (...):" up to the next one) are independent of each other, so their lines are
+     * parsed on this pool while further output arrives. The results are merged in order, so the outcome is the same
+     * as when parsing serially. A block is merged once it is parsed, the getters describe the lines merged so far
+     * and all of them once the generator sent its final null line. Defaults to the global thread pool, nullptr
+     * parses in the calling thread.
+     */
+    void setThreadPool(QThreadPool *pool);
+
 protected:
     BacktraceParserPrivate *constructPrivate() const override;
 
@@ -38,6 +50,12 @@ protected Q_SLOTS:
 
 private:
     void parseLine(const QString &lineStr);
+    void processLine(const BacktraceLineGdb &line);
+    void dispatchBlock();
+    void applyBlocks(bool wait);
+    void flushBlocks();
+
+    QThreadPool *m_threadPool;
 };
 
 #endif // BACKTRACEPARSERGDB_H
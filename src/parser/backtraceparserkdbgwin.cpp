@@ -24,7 +24,7 @@ private:
 BacktraceLineKdbgwin::BacktraceLineKdbgwin(const QString &line)
     : BacktraceLine()
 {
-    d->m_line = line;
+    setLine(line);
     parse();
     if (d->m_type == StackFrame) {
         rate();
@@ -33,13 +33,14 @@ BacktraceLineKdbgwin::BacktraceLineKdbgwin(const QString &line)
 
 void BacktraceLineKdbgwin::parse()
 {
-    if (d->m_line == QLatin1Char('\n')) {
+    const QStringView lineStr = lineView();
+    if (lineStr == QLatin1String("\n")) {
         d->m_type = EmptyLine;
         return;
-    } else if (d->m_line == QLatin1String("[KCrash Handler]\n")) {
+    } else if (lineStr == QLatin1String("[KCrash Handler]\n")) {
         d->m_type = KCrash;
         return;
-    } else if (d->m_line.startsWith(QLatin1String("Loaded"))) {
+    } else if (lineStr.startsWith(QLatin1String("Loaded"))) {
         d->m_type = Crap; // FIXME that's not exactly crap
         return;
     }
@@ -50,18 +51,18 @@ void BacktraceLineKdbgwin::parse()
                                                            "\\[([^@]+)@ [\\-\\d]+\\] " // [filename @ line]
                                                            "at 0x.*"))); // at 0xdeadbeef
 
-    const QRegularExpressionMatch match = re.match(d->m_line);
+    const QRegularExpressionMatch match = re.matchView(lineStr);
     if (match.hasMatch()) {
         d->m_type = StackFrame;
-        d->m_library = match.captured(1);
-        d->m_functionName = match.captured(2);
-        d->m_file = match.captured(3).trimmed();
+        setLibraryName(match.capturedView(1));
+        setFunctionName(match.capturedView(2));
+        setFileName(match.capturedView(3).trimmed());
 
-        qCDebug(DRKONQI_PARSER_LOG) << d->m_functionName << d->m_file << d->m_library;
+        qCDebug(DRKONQI_PARSER_LOG) << functionNameView() << fileNameView() << libraryNameView();
         return;
     }
 
-    qCDebug(DRKONQI_PARSER_LOG) << "line" << d->m_line << "did not match";
+    qCDebug(DRKONQI_PARSER_LOG) << "line" << lineStr << "did not match";
 }
 
 void BacktraceLineKdbgwin::rate()
@@ -69,16 +70,16 @@ void BacktraceLineKdbgwin::rate()
     LineRating r;
 
     // for explanations, see the LineRating enum definition
-    if (fileName() != QLatin1String("[unknown]")) {
+    if (fileNameView() != QLatin1String("[unknown]")) {
         r = Good;
-    } else if (libraryName() != QLatin1String("[unknown]")) {
-        if (functionName() == QLatin1String("[unknown]")) {
+    } else if (libraryNameView() != QLatin1String("[unknown]")) {
+        if (functionNameView() == QLatin1String("[unknown]")) {
             r = MissingFunction;
         } else {
             r = MissingSourceFile;
         }
     } else {
-        if (functionName() == QLatin1String("[unknown]")) {
+        if (functionNameView() == QLatin1String("[unknown]")) {
             r = MissingEverything;
         } else {
             r = MissingLibrary;
@@ -106,10 +107,10 @@ void BacktraceParserKdbgwin::newLine(const QString &lineStr)
     case BacktraceLine::Crap:
         break; // we don't want crap in the backtrace ;)
     case BacktraceLine::StackFrame:
-        d->m_linesToRate.append(line);
+        d->appendLineToRate(line);
         Q_FALLTHROUGH();
     default:
-        d->m_linesList.append(line);
+        d->appendLine(line);
     }
 }
 
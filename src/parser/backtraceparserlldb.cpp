@@ -17,7 +17,7 @@ public:
 BacktraceLineLldb::BacktraceLineLldb(const QString &line)
     : BacktraceLine()
 {
-    d->m_line = line;
+    setLine(line);
     // For now we'll have faith that lldb provides useful information, and that it would
     // be unwarranted to give it a rating of "MissingEverything".
     d->m_rating = Good;
@@ -41,7 +41,7 @@ BacktraceParserPrivate *BacktraceParserLldb::constructPrivate() const
 
 void BacktraceParserLldb::newLine(const QString &lineStr)
 {
-    d_ptr->m_linesList.append(BacktraceLineLldb(lineStr));
+    d_ptr->appendLine(BacktraceLineLldb(lineStr));
 }
 
 // END BacktraceParserLldb
@@ -17,7 +17,7 @@ public:
 BacktraceLineNull::BacktraceLineNull(const QString &line)
     : BacktraceLine()
 {
-    d->m_line = line;
+    setLine(line);
     d->m_rating = MissingEverything;
 }
 
@@ -39,7 +39,7 @@ BacktraceParserPrivate *BacktraceParserNull::constructPrivate() const
 
 void BacktraceParserNull::newLine(const QString &lineStr)
 {
-    d_ptr->m_linesList.append(BacktraceLineNull(lineStr));
+    d_ptr->appendLine(BacktraceLineNull(lineStr));
 }
 
 // END BacktraceParserNull
@@ -0,0 +1,114 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "backtracesimilarity.h"
+
+#include <QtAlgorithms>
+
+#include <algorithm>
+#include <array>
+
+namespace
+{
+quint64 lowBits(qsizetype count)
+{
+    return count >= 64 ? ~quint64(0) : (quint64(1) << count) - 1;
+}
+} // namespace
+
+BacktraceSimilarity::BacktraceSimilarity(const Frames &query, const Metric &metric)
+    : m_query(query.mid(0, MaxFrames))
+    , m_metric(metric)
+{
+    m_weights.reserve(MaxFrames);
+    for (qsizetype position = 0; position < MaxFrames; ++position) {
+        m_weights.append(1.0 / (1.0 + m_metric.positionDecay * double(position)));
+    }
+    for (qsizetype position = 0; position < m_query.size(); ++position) {
+        m_queryWeightSum += m_weights.at(position);
+        m_matchMasks[m_query.at(position)] |= quint64(1) << position;
+    }
+}
+
+double BacktraceSimilarity::weight(qsizetype position) const
+{
+    return m_weights.at(position);
+}
+
+qsizetype BacktraceSimilarity::longestCommonSubsequence(const Frames &candidate) const
+{
+    // Allison-Dix/Hyyrö: bit i of ~v tells whether the LCS of the query prefix up to i and the candidate
+    // prefix so far grew at i. Each candidate frame updates all query positions at once.
+    quint64 v = ~quint64(0);
+    const qsizetype candidateSize = std::min(candidate.size(), MaxFrames);
+    for (qsizetype j = 0; j < candidateSize; ++j) {
+        const quint64 u = v & m_matchMasks.value(candidate.at(j));
+        v = (v + u) | (v - u);
+    }
+    return qPopulationCount(~v & lowBits(m_query.size()));
+}
+
+double BacktraceSimilarity::score(const Frames &candidate, double minimumScore) const
+{
+    const qsizetype candidateSize = std::min(candidate.size(), MaxFrames);
+    if (m_query.isEmpty() || candidateSize == 0) {
+        return 0;
+    }
+
+    double candidateWeightSum = 0;
+    for (qsizetype position = 0; position < candidateSize; ++position) {
+        candidateWeightSum += weight(position);
+    }
+    // deleting every frame of one and inserting every frame of the other is always possible
+    const double maximumDistance = m_metric.indelCost * (m_queryWeightSum + candidateWeightSum);
+    if (maximumDistance <= 0) {
+        return 0;
+    }
+
+    if (minimumScore > 0) {
+        // Every frame outside the best alignment costs at least the cheapest operation at the smallest weight.
+        const qsizetype unmatched = m_query.size() + candidateSize - 2 * longestCommonSubsequence(candidate);
+        const double cheapest = std::min(m_metric.indelCost, m_metric.substitutionCost / 2);
+        const double minimumDistance = cheapest * weight(std::max(m_query.size(), candidateSize) - 1) * double(unmatched);
+        if (1.0 - minimumDistance / maximumDistance < minimumScore) {
+            return 0;
+        }
+    }
+
+    return std::clamp(1.0 - distance(candidate, candidateSize) / maximumDistance, 0.0, 1.0);
+}
+
+double BacktraceSimilarity::distance(const Frames &candidate, qsizetype candidateSize) const
+{
+    // Two rows of the DP matrix over (query prefix, candidate prefix), on the stack.
+    std::array<double, MaxFrames + 1> previous;
+    std::array<double, MaxFrames + 1> current;
+
+    previous[0] = 0;
+    for (qsizetype j = 1; j <= candidateSize; ++j) {
+        previous[j] = previous[j - 1] + m_metric.indelCost * weight(j - 1);
+    }
+
+    for (qsizetype i = 1; i <= m_query.size(); ++i) {
+        const SymbolTable::Id frame = m_query.at(i - 1);
+        const double queryWeight = weight(i - 1);
+        const double deletion = m_metric.indelCost * queryWeight;
+        current[0] = previous[0] + deletion;
+
+        // Deletions and matches/substitutions only depend on the previous row, this loop has no dependency between
+        // iterations and vectorizes. Insertions depend on the current row and are resolved in a second, scalar pass.
+        for (qsizetype j = 1; j <= candidateSize; ++j) {
+            const double substitution = frame == candidate.at(j - 1) ? 0.0 : m_metric.substitutionCost * (queryWeight + weight(j - 1)) / 2;
+            current[j] = std::min(previous[j] + deletion, previous[j - 1] + substitution);
+        }
+        for (qsizetype j = 1; j <= candidateSize; ++j) {
+            current[j] = std::min(current[j], current[j - 1] + m_metric.indelCost * weight(j - 1));
+        }
+
+        std::swap(previous, current);
+    }
+
+    return previous[candidateSize];
+}
@@ -0,0 +1,64 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QHash>
+#include <QList>
+
+#include "symboltable.h"
+
+/*!
+ * Scores how similar the frames of a backtrace are to those of other backtraces, e.g. the useful frames of the crashed
+ * threads (see CrashSignature::usefulFrames()), as interned normalized function names.
+ *
+ * The score is derived from a weighted edit distance. Every frame has a weight decreasing with its distance from the top
+ * of the stack, since the frames near the crash say the most about it. A frame present in only one of the backtraces
+ * (an inlined function, an extra or missing frame shifting the rest) costs indelCost of its weight, two different frames
+ * in the same place cost substitutionCost of their mean weight. The score is 1 - distance / (cost of deleting all frames
+ * of both backtraces), i.e. 1 for equal and 0 for entirely different frames.
+ *
+ * The query is preprocessed once so that many candidates can be scored against it cheaply: a bit-parallel longest common
+ * subsequence (one machine word operation per candidate frame) bounds the score from above and rules out candidates
+ * that can't reach the minimum score before the quadratic distance is computed. Only the top MaxFrames frames are
+ * compared.
+ */
+class BacktraceSimilarity
+{
+public:
+    using Frames = QList<SymbolTable::Id>;
+
+    struct Metric {
+        // the weight of the frame at position i is 1 / (1 + positionDecay * i)
+        double positionDecay = 0.25;
+        double indelCost = 0.5;
+        double substitutionCost = 1.0;
+    };
+
+    /*! Frames beyond this are not compared, it is the width of the bit vectors. */
+    static constexpr qsizetype MaxFrames = 64;
+
+    explicit BacktraceSimilarity(const Frames &query, const Metric &metric = {});
+
+    /*!
+     * Returns the similarity of candidate to the query, between 0 and 1.
+     * Candidates that can't reach minimumScore are not scored exactly and yield 0.
+     */
+    [[nodiscard]] double score(const Frames &candidate, double minimumScore = 0) const;
+
+    /*! Returns the length of the longest common subsequence of the query and candidate (bit-parallel). */
+    [[nodiscard]] qsizetype longestCommonSubsequence(const Frames &candidate) const;
+
+private:
+    [[nodiscard]] double weight(qsizetype position) const;
+    [[nodiscard]] double distance(const Frames &candidate, qsizetype candidateSize) const;
+
+    Frames m_query;
+    Metric m_metric;
+    QList<double> m_weights; // of positions 0 to MaxFrames - 1
+    double m_queryWeightSum = 0;
+    // bit i is set in the mask of the frame at position i of the query
+    QHash<SymbolTable::Id, quint64> m_matchMasks;
+};
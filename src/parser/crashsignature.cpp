@@ -0,0 +1,190 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "crashsignature.h"
+
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#define HAVE_CXXABI
+#endif
+
+#include "framerules.h"
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+// FNV-1a, unlike qHash() it is not seeded per process
+constexpr quint64 FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+constexpr quint64 FNV_PRIME = 0x100000001b3ULL;
+
+quint64 fnv1a(quint64 hash, const char *data, qsizetype size)
+{
+    for (qsizetype i = 0; i < size; ++i) {
+        hash ^= uchar(data[i]);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+bool hasFunctionName(const BacktraceLine &line)
+{
+    return line.rating() != BacktraceLine::MissingEverything && line.rating() != BacktraceLine::MissingFunction;
+}
+
+QString demangled(QStringView name)
+{
+#ifdef HAVE_CXXABI
+    // Debuggers usually demangle already, but not when they lack the symbols' language information.
+    if (name.startsWith(u"_Z")) {
+        int status = 0;
+        const std::unique_ptr<char, decltype(&std::free)> result(abi::__cxa_demangle(name.toUtf8().constData(), nullptr, nullptr, &status),
+                                                                 &std::free);
+        if (status == 0 && result) {
+            return QString::fromUtf8(result.get());
+        }
+    }
+#endif
+    return name.toString();
+}
+
+bool isIdentifierCharacter(QChar c)
+{
+    return c.isLetterOrNumber() || c == u'_';
+}
+
+// Characters an operator name (after "operator") is made of
+bool isOperatorCharacter(QChar c)
+{
+    return QStringView(u"<>=!+-*/%^&|~[],").contains(c);
+}
+} // namespace
+
+QString CrashSignature::normalizedFunctionName(QStringView functionName)
+{
+    QString name = demangled(functionName.trimmed());
+
+    for (const QLatin1StringView thunk : {"non-virtual thunk to "_L1, "virtual thunk to "_L1}) {
+        if (name.startsWith(thunk)) {
+            name.remove(0, thunk.size());
+        }
+    }
+
+    // Compiler clones of the function, e.g. "foo.isra.0" or "foo.cold"
+    for (const QLatin1StringView clone : {".isra"_L1, ".constprop"_L1, ".part"_L1, ".cold"_L1, ".lto_priv"_L1, ".localalias"_L1}) {
+        if (const qsizetype index = name.indexOf(clone); index > 0) {
+            name.truncate(index);
+        }
+    }
+
+    // Drop parameter and template argument lists as well as tags like "[clone .isra.0]" and "[abi:cxx11]", they
+    // differ between debuggers and builds. Anonymous namespaces and operator names are kept.
+    QString result;
+    result.reserve(name.size());
+    qsizetype depth = 0;
+    for (qsizetype i = 0; i < name.size(); ++i) {
+        const QStringView rest = QStringView(name).mid(i);
+        if (depth == 0 && rest.startsWith(u"(anonymous namespace)")) {
+            constexpr qsizetype length = std::char_traits<char16_t>::length(u"(anonymous namespace)");
+            result += rest.left(length);
+            i += length - 1;
+            continue;
+        }
+        if (depth == 0 && rest.startsWith(u"operator") && (i == 0 || !isIdentifierCharacter(name.at(i - 1)))) {
+            constexpr qsizetype length = std::char_traits<char16_t>::length(u"operator");
+            qsizetype end = length;
+            if (rest.mid(end).startsWith(u"()")) {
+                end += 2;
+            } else {
+                while (end < rest.size() && isOperatorCharacter(rest.at(end))) {
+                    ++end;
+                }
+            }
+            result += rest.left(end);
+            i += end - 1;
+            continue;
+        }
+
+        const QChar c = name.at(i);
+        if (c == u'(' || c == u'<' || c == u'[') {
+            ++depth;
+        } else if (c == u')' || c == u'>' || c == u']') {
+            depth = std::max<qsizetype>(depth - 1, 0);
+        } else if (depth == 0) {
+            result += c;
+        }
+    }
+
+    result = result.simplified();
+    for (const QLatin1StringView qualifier : {" const"_L1, " volatile"_L1, " &&"_L1, " &"_L1}) {
+        if (result.endsWith(qualifier)) {
+            result.chop(qualifier.size());
+        }
+    }
+    return result;
+}
+
+QList<CrashSignature::UsefulFrame> CrashSignature::usefulFrames(const StructuredBacktrace &backtrace)
+{
+    const StructuredBacktrace::Thread *thread = backtrace.crashedThread();
+    if (!thread) {
+        return {};
+    }
+
+    const FrameRules &rules = FrameRules::instance();
+    QList<UsefulFrame> frames;
+    for (qsizetype index = thread->crashFrame; index < thread->frames.size(); ++index) {
+        const BacktraceLine &line = thread->frames.at(index).line;
+        if (!hasFunctionName(line)) {
+            continue;
+        }
+        // classified by the normalized name, gdb prints some functions with their parameters, e.g. "qFatal(char const*, ...)"
+        QString name = normalizedFunctionName(line.functionNameView());
+        const FrameRules::Categories categories = rules.classify(name, line.libraryNameView());
+        if (categories.testFlag(FrameRules::StackBase)) {
+            break;
+        }
+        if (categories.testFlag(FrameRules::StackTop)) {
+            // everything above it is the machinery of aborting
+            frames.clear();
+            continue;
+        }
+        if (categories.testAnyFlags(FrameRules::Ignored | FrameRules::NotUseful)) {
+            continue;
+        }
+        if (!name.isEmpty()) {
+            frames.append({index, std::move(name)});
+        }
+    }
+    return frames;
+}
+
+CrashSignature CrashSignature::fromBacktrace(const StructuredBacktrace &backtrace)
+{
+    const QList<UsefulFrame> frames = usefulFrames(backtrace);
+    if (frames.isEmpty()) {
+        return {};
+    }
+
+    CrashSignature signature;
+    signature.m_hash = FNV_OFFSET_BASIS;
+    for (qsizetype i = 0; i < std::min(frames.size(), Depth); ++i) {
+        const QString &frame = frames.at(i).name;
+        const QByteArray utf8 = frame.toUtf8();
+        const quint64 frameHash = fnv1a(FNV_OFFSET_BASIS, utf8.constData(), utf8.size());
+        signature.m_frames.append(frame);
+        signature.m_frameHashes.append(frameHash);
+        const quint64 frameHashLE = qToLittleEndian(frameHash);
+        signature.m_hash = fnv1a(signature.m_hash, reinterpret_cast<const char *>(&frameHashLE), sizeof(frameHashLE));
+    }
+    return signature;
+}
@@ -0,0 +1,74 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+
+#include "structuredbacktrace.h"
+
+/*!
+ * A normalized fingerprint of a crash: the top useful frames of the crashed thread, hashed.
+ *
+ * Frames without a function name and frames FrameRules considers noise (ignored libraries, raise(), abort() and
+ * everything above a stack top like qFatal()) are skipped, the walk stops at the stack base. Function names are
+ * demangled and stripped of parameter and template argument lists, qualifiers and compiler clone suffixes
+ * (e.g. ".isra.0"), so that traces of different builds and debuggers of the same crash yield the same signature.
+ *
+ * The hashes are stable across processes and may be stored.
+ */
+class CrashSignature
+{
+public:
+    /*! The amount of frames making up a signature. */
+    static constexpr qsizetype Depth = 5;
+
+    CrashSignature() = default;
+
+    /*! A frame of the crashed thread that is not noise. */
+    struct UsefulFrame {
+        qsizetype index = -1; // into the crashed thread's frames
+        QString name; // normalized function name
+    };
+
+    static CrashSignature fromBacktrace(const StructuredBacktrace &backtrace);
+    static QString normalizedFunctionName(QStringView functionName);
+    /*! All useful frames of the crashed thread, topmost first. The signature is made of the first Depth of them. */
+    static QList<UsefulFrame> usefulFrames(const StructuredBacktrace &backtrace);
+
+    /*! Whether the backtrace had no crashed thread or no useful frame in it. */
+    bool isEmpty() const
+    {
+        return m_frames.isEmpty();
+    }
+    /*! The normalized function names, topmost frame first. */
+    const QStringList &frames() const
+    {
+        return m_frames;
+    }
+    /*! The hashes of frames(), in the same order. */
+    const QList<quint64> &frameHashes() const
+    {
+        return m_frameHashes;
+    }
+    /*! The hash of the whole signature, equal signatures have equal hashes. */
+    quint64 hash() const
+    {
+        return m_hash;
+    }
+
+    bool operator==(const CrashSignature &other) const
+    {
+        return m_frameHashes == other.m_frameHashes;
+    }
+
+private:
+    QStringList m_frames;
+    QList<quint64> m_frameHashes;
+    quint64 m_hash = 0;
+};
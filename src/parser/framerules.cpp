@@ -0,0 +1,375 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "framerules.h"
+
+#include "backtraceline.h"
+#include "drkonqi_parser_debug.h"
+
+#include <QFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+
+namespace
+{
+// Patterns are anchored by wrapping the text in characters that never appear in symbol names.
+constexpr char16_t TEXT_BEGIN = u'\x02';
+constexpr char16_t TEXT_END = u'\x03';
+
+constexpr QStringView BUILTIN_RULES = uR"(
+# "start_thread" is the base frame for all threads except the main thread, FIXME "start_thread"
+# probably works only on linux
+# main() or kdemain() is the base for the main thread
+StackBase function equals start_thread
+StackBase function equals main
+StackBase function equals kdemain
+# HACK for better rating. we ignore all stack frames below QApplication::notify and similar, which
+# are used to send any kind of event to the Qt application. All stack frames below this,
+# with or without debug symbols, are useless to KDE developers, so we ignore them.
+StackBase function startsWith QApplication::notify
+StackBase function startsWith QApplicationPrivate::notify
+StackBase function startsWith QCoreApplication::notify
+StackBase function startsWith QCoreApplicationPrivate::notify
+StackBase function startsWith KApplication::notify
+StackBase function startsWith KApplicationPrivate::notify
+StackBase function startsWith KCoreApplication::notify
+StackBase function startsWith KCoreApplicationPrivate::notify
+# attempt to recognize crashes that happen after main has returned (bug 200993)
+StackBase function equals ~KCleanUpGlobalStatic
+StackBase function equals ~QGlobalStatic
+StackBase function equals exit
+StackBase function equals *__GI_exit
+
+# abort(), assert(), Q_ASSERT() and qFatal()
+StackTop function startsWith qt_assert
+StackTop function equals qFatal
+StackTop function equals abort
+StackTop function equals *__GI_abort
+StackTop function equals *__GI___assert_fail
+
+# libc/libstdc++/libpthread functions
+Ignored library contains libc.so
+Ignored library contains libstdc++.so
+Ignored library contains libpthread.so
+Ignored library contains libglib-2.0.so
+# glibc2.9 uses *__GI_ as prefix
+Ignored function startsWith *__GI_
+# below main on apps without symbols
+Ignored function equals __libc_start_main
+Ignored function equals _start
+Ignored library contains ntdll.dll
+Ignored library contains kernel32.dll
+Ignored function contains _tmain
+Ignored function equals WinMain
+
+# Misc ignores
+NotUseful function equals __kernel_vsyscall
+NotUseful function equals raise
+NotUseful function equals abort
+NotUseful function equals __libc_message
+NotUseful function equals thr_kill
+# Ignore core Qt functions (QObject can be useful in some cases)
+NotUseful function startsWith QBasicAtomicInt::
+NotUseful function startsWith QBasicAtomicPointer::
+NotUseful function startsWith QAtomicInt::
+NotUseful function startsWith QAtomicPointer::
+NotUseful function startsWith QMetaObject::
+NotUseful function startsWith QPointer::
+NotUseful function startsWith QWeakPointer::
+NotUseful function startsWith QSharedPointer::
+NotUseful function startsWith QScopedPointer::
+NotUseful function startsWith QMetaCallEvent::
+# Ignore core Qt containers misc functions
+NotUseful function endsWith detach
+NotUseful function endsWith detach_helper
+NotUseful function endsWith node_create
+NotUseful function endsWith deref
+NotUseful function endsWith ref
+NotUseful function endsWith node_copy
+NotUseful function endsWith d_func
+# Misc Qt stuff
+NotUseful function equals qt_message_output
+NotUseful function equals qt_message
+NotUseful function equals qFatal
+NotUseful function startsWith qGetPtrHelper
+NotUseful function startsWith qt_meta_
+
+# Ignore Qt containers (and iterators Q*Iterator)
+NotUsefulForSearch function startsWith QList
+NotUsefulForSearch function startsWith QLinkedList
+NotUsefulForSearch function startsWith QVector
+NotUsefulForSearch function startsWith QStack
+NotUsefulForSearch function startsWith QQueue
+NotUsefulForSearch function startsWith QSet
+NotUsefulForSearch function startsWith QMap
+NotUsefulForSearch function startsWith QMultiMap
+NotUsefulForSearch function startsWith QMapData
+NotUsefulForSearch function startsWith QHash
+NotUsefulForSearch function startsWith QMultiHash
+NotUsefulForSearch function startsWith QHashData
+)";
+
+#ifdef Q_OS_MACOS
+constexpr QStringView BUILTIN_MACOS_RULES = uR"(
+Ignored library startsAndEndsWith libsystem_*.dylib
+Ignored library contains Foundation`
+)";
+#endif
+
+std::optional<FrameRules::Category> categoryFromString(QStringView name)
+{
+    static const std::pair<QLatin1String, FrameRules::Category> categories[] = {
+        {QLatin1String("StackBase"), FrameRules::StackBase},
+        {QLatin1String("StackTop"), FrameRules::StackTop},
+        {QLatin1String("Ignored"), FrameRules::Ignored},
+        {QLatin1String("NotUseful"), FrameRules::NotUseful},
+        {QLatin1String("NotUsefulForSearch"), FrameRules::NotUsefulForSearch},
+    };
+    for (const auto &[string, category] : categories) {
+        if (name == string) {
+            return category;
+        }
+    }
+    return std::nullopt;
+}
+
+QStringView takeWord(QStringView &rest)
+{
+    qsizetype end = 0;
+    while (end < rest.size() && !rest[end].isSpace()) {
+        ++end;
+    }
+    const QStringView word = rest.first(end);
+    rest = rest.sliced(end).trimmed();
+    return word;
+}
+} // namespace
+
+// BEGIN Automaton
+
+void FrameRules::Automaton::addPattern(QStringView pattern, Categories categories, std::optional<qsizetype> conditionalIndex)
+{
+    qsizetype node = 0;
+    for (const QChar c : pattern) {
+        auto &next = m_nodes[node].next;
+        const auto it = std::lower_bound(next.begin(), next.end(), c.unicode(), [](const auto &pair, char16_t value) {
+            return pair.first < value;
+        });
+        if (it != next.end() && it->first == c.unicode()) {
+            node = it->second;
+            continue;
+        }
+        const qsizetype newNode = m_nodes.size();
+        next.insert(it, {c.unicode(), newNode});
+        m_nodes.append(Node());
+        node = newNode;
+    }
+
+    if (conditionalIndex.has_value()) {
+        m_nodes[node].ownConditionals.append(conditionalIndex.value());
+    } else {
+        m_nodes[node].ownCategories |= categories;
+    }
+}
+
+void FrameRules::Automaton::compile()
+{
+    // Breadth first so the fail target of a node (which is always shallower) is complete before the node itself.
+    QList<qsizetype> queue;
+    queue.reserve(m_nodes.size());
+    m_nodes[0].categories = m_nodes[0].ownCategories;
+    m_nodes[0].conditionals = m_nodes[0].ownConditionals;
+    for (const auto &[c, target] : std::as_const(m_nodes[0].next)) {
+        m_nodes[target].fail = 0;
+        queue.append(target);
+    }
+
+    for (qsizetype i = 0; i < queue.size(); ++i) {
+        const qsizetype node = queue.at(i);
+        const qsizetype fail = m_nodes.at(node).fail;
+        m_nodes[node].categories = m_nodes.at(node).ownCategories | m_nodes.at(fail).categories;
+        m_nodes[node].conditionals = m_nodes.at(node).ownConditionals + m_nodes.at(fail).conditionals;
+        for (const auto &[c, target] : std::as_const(m_nodes.at(node).next)) {
+            m_nodes[target].fail = step(fail, c);
+            queue.append(target);
+        }
+    }
+}
+
+qsizetype FrameRules::Automaton::child(qsizetype node, char16_t c) const
+{
+    const auto &next = m_nodes.at(node).next;
+    const auto it = std::lower_bound(next.cbegin(), next.cend(), c, [](const auto &pair, char16_t value) {
+        return pair.first < value;
+    });
+    return (it != next.cend() && it->first == c) ? it->second : -1;
+}
+
+qsizetype FrameRules::Automaton::step(qsizetype node, char16_t c) const
+{
+    while (true) {
+        if (const qsizetype next = child(node, c); next >= 0) {
+            return next;
+        }
+        if (node == 0) {
+            return 0;
+        }
+        node = m_nodes.at(node).fail;
+    }
+}
+
+FrameRules::Categories FrameRules::Automaton::match(QStringView text, const QList<Conditional> &conditionals) const
+{
+    Categories result;
+    qsizetype node = 0;
+    auto feed = [&](char16_t c) {
+        node = step(node, c);
+        const Node &current = m_nodes.at(node);
+        result |= current.categories;
+        for (const qsizetype index : current.conditionals) {
+            const Conditional &conditional = conditionals.at(index);
+            if (text.size() >= conditional.minimumLength && text.endsWith(conditional.suffix)) {
+                result |= conditional.categories;
+            }
+        }
+    };
+
+    feed(TEXT_BEGIN);
+    for (const QChar c : text) {
+        feed(c.unicode());
+    }
+    feed(TEXT_END);
+    return result;
+}
+
+// END Automaton
+
+// BEGIN FrameRules
+
+const FrameRules &FrameRules::instance()
+{
+    static const FrameRules rules = [] {
+        FrameRules rules;
+        [[maybe_unused]] bool builtinOk = rules.addRules(BUILTIN_RULES);
+#ifdef Q_OS_MACOS
+        builtinOk = rules.addRules(BUILTIN_MACOS_RULES) && builtinOk;
+#endif
+        Q_ASSERT(builtinOk);
+
+        const QStringList files = QStandardPaths::locateAll(QStandardPaths::GenericDataLocation, QStringLiteral("drkonqi/framerules"));
+        for (const QString &file : files) {
+            QString errorString;
+            if (!rules.addRulesFromFile(file, &errorString)) {
+                qCWarning(DRKONQI_PARSER_LOG) << "Failed to load frame rules from" << file << errorString;
+            }
+        }
+        return rules;
+    }();
+    return rules;
+}
+
+bool FrameRules::addRules(QStringView rules, QString *errorString)
+{
+    bool ok = true;
+    auto fail = [&](int lineNumber, const QString &error) {
+        ok = false;
+        if (errorString) {
+            errorString->append(QStringLiteral("line %1: %2\n").arg(QString::number(lineNumber), error));
+        }
+    };
+
+    int lineNumber = 0;
+    for (QStringView line : rules.split(u'\n')) {
+        ++lineNumber;
+        line = line.trimmed();
+        if (line.isEmpty() || line.startsWith(u'#')) {
+            continue;
+        }
+
+        QStringView rest = line;
+        const QStringView categoryName = takeWord(rest);
+        const QStringView field = takeWord(rest);
+        const QStringView match = takeWord(rest);
+        const QStringView pattern = rest;
+
+        const auto category = categoryFromString(categoryName);
+        if (!category.has_value()) {
+            fail(lineNumber, QStringLiteral("unknown category '%1'").arg(categoryName));
+            continue;
+        }
+
+        Automaton *automaton = nullptr;
+        if (field == QLatin1String("function")) {
+            automaton = &m_function;
+        } else if (field == QLatin1String("library")) {
+            automaton = &m_library;
+        } else {
+            fail(lineNumber, QStringLiteral("unknown field '%1'").arg(field));
+            continue;
+        }
+
+        if (pattern.isEmpty()) {
+            fail(lineNumber, QStringLiteral("missing pattern"));
+            continue;
+        }
+
+        QString encoded;
+        std::optional<qsizetype> conditionalIndex;
+        if (match == QLatin1String("equals")) {
+            encoded = QChar(TEXT_BEGIN) + pattern.toString() + QChar(TEXT_END);
+        } else if (match == QLatin1String("startsWith")) {
+            encoded = QChar(TEXT_BEGIN) + pattern.toString();
+        } else if (match == QLatin1String("endsWith")) {
+            encoded = pattern.toString() + QChar(TEXT_END);
+        } else if (match == QLatin1String("contains")) {
+            encoded = pattern.toString();
+        } else if (match == QLatin1String("startsAndEndsWith")) {
+            const qsizetype star = pattern.indexOf(u'*');
+            if (star < 0) {
+                fail(lineNumber, QStringLiteral("startsAndEndsWith needs a pattern of the form prefix*suffix"));
+                continue;
+            }
+            const QStringView prefix = pattern.first(star);
+            const QStringView suffix = pattern.sliced(star + 1);
+            encoded = QChar(TEXT_BEGIN) + prefix.toString();
+            conditionalIndex = m_conditionals.size();
+            m_conditionals.append({*category, suffix.toString(), prefix.size() + suffix.size()});
+        } else {
+            fail(lineNumber, QStringLiteral("unknown match '%1'").arg(match));
+            continue;
+        }
+
+        automaton->addPattern(encoded, *category, conditionalIndex);
+    }
+
+    m_function.compile();
+    m_library.compile();
+    return ok;
+}
+
+bool FrameRules::addRulesFromFile(const QString &path, QString *errorString)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        return false;
+    }
+    return addRules(QString::fromUtf8(file.readAll()), errorString);
+}
+
+FrameRules::Categories FrameRules::classify(QStringView functionName, QStringView libraryName) const
+{
+    return m_function.match(functionName, m_conditionals) | m_library.match(libraryName, m_conditionals);
+}
+
+FrameRules::Categories FrameRules::classify(const BacktraceLine &line) const
+{
+    return classify(line.functionNameView(), line.libraryNameView());
+}
+
+// END FrameRules
@@ -0,0 +1,92 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QFlags>
+#include <QList>
+#include <QString>
+#include <QStringView>
+
+#include <optional>
+#include <utility>
+
+class BacktraceLine;
+
+/*!
+ * The rules BacktraceParser uses to classify stack frames while rating a backtrace (e.g. "start_thread is the base of
+ * a stack", "frames in libc are ignored"), compiled into one Aho-Corasick automaton per field so that each frame is
+ * classified in a single pass over its function and library name.
+ *
+ * Rules are written one per line:
+ *
+ *   <Category> <function|library> <equals|startsWith|endsWith|contains|startsAndEndsWith> <pattern>
+ *
+ * The pattern is the rest of the line and may contain spaces. For startsAndEndsWith the pattern is split at the
+ * first '*' into prefix and suffix. Empty lines and lines starting with '#' are ignored.
+ */
+class FrameRules
+{
+public:
+    enum Category {
+        StackBase = 1 << 0, //< the base of a stack, frames below it are not rated
+        StackTop = 1 << 1, //< the top of a stack (e.g. abort()), frames above it are not rated
+        Ignored = 1 << 2, //< not rated at all
+        NotUseful = 1 << 3, //< not part of the simplified backtrace
+        NotUsefulForSearch = 1 << 4, //< not used for duplicate search queries
+    };
+    Q_DECLARE_FLAGS(Categories, Category)
+
+    /*! The built-in rules plus the rules from all "drkonqi/framerules" files in the generic data locations.
+     * Constructed on first use.
+     */
+    static const FrameRules &instance();
+
+    FrameRules() = default;
+
+    /*! Parses rules and adds them. Returns false if a line could not be parsed; all other lines are still added. */
+    bool addRules(QStringView rules, QString *errorString = nullptr);
+    bool addRulesFromFile(const QString &path, QString *errorString = nullptr);
+
+    [[nodiscard]] Categories classify(QStringView functionName, QStringView libraryName) const;
+    [[nodiscard]] Categories classify(const BacktraceLine &line) const;
+
+private:
+    // A pattern with a suffix that needs checking after its prefix matched (startsAndEndsWith).
+    struct Conditional {
+        Categories categories;
+        QString suffix;
+        qsizetype minimumLength;
+    };
+
+    class Automaton
+    {
+    public:
+        void addPattern(QStringView pattern, Categories categories, std::optional<qsizetype> conditionalIndex);
+        void compile();
+        [[nodiscard]] Categories match(QStringView text, const QList<Conditional> &conditionals) const;
+
+    private:
+        struct Node {
+            QList<std::pair<char16_t, qsizetype>> next; // sorted by character
+            qsizetype fail = 0;
+            Categories ownCategories; // of the patterns ending in this node
+            QList<qsizetype> ownConditionals;
+            Categories categories; // of all patterns ending in this node or any node on its fail chain
+            QList<qsizetype> conditionals;
+        };
+
+        [[nodiscard]] qsizetype child(qsizetype node, char16_t c) const;
+        [[nodiscard]] qsizetype step(qsizetype node, char16_t c) const;
+
+        QList<Node> m_nodes{Node()};
+    };
+
+    Automaton m_function;
+    Automaton m_library;
+    QList<Conditional> m_conditionals;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(FrameRules::Categories)
@@ -0,0 +1,235 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "gdbframetokenizer.h"
+
+#include <QString>
+
+#include <algorithm>
+
+// The tokenizer implements the following (former) regular expression, anchored, with '.' matching newlines:
+//
+//   #([0-9]+)                                   frame number
+//   [\s]+(?:0x[0-9a-f]+[\s]+in[\s]+)?           optional address
+//   ((?:\(anonymous namespace\)::)?[^\(]+)?     function name
+//   (?:\(.*\))?                                 function signature (when the app doesn't have debugging symbols)
+//   [\s]+(?:const[\s]+)?                        trailing const
+//   \(.*\)                                      arguments with their values
+//   ([\s]+(from|at)[\s]+(.+))?\n                optional location and trailing newline
+//
+// Because all '.*' are greedy, the argument list always ends at the last ')' that is followed by a valid location
+// (or just the trailing newline). Everything else can then be decided in a single forward pass. The order in which
+// alternatives are tried below mirrors the order in which a backtracking engine would have tried them, so that the
+// spans are the same as the regex captures.
+
+namespace
+{
+const QLatin1String ANONYMOUS_NAMESPACE("(anonymous namespace)::");
+
+// \s without unicode properties
+constexpr bool isSpace(QChar c)
+{
+    const char16_t u = c.unicode();
+    return u == u' ' || (u >= u'\t' && u <= u'\r');
+}
+
+constexpr bool isDigit(QChar c)
+{
+    return c.unicode() >= u'0' && c.unicode() <= u'9';
+}
+
+constexpr bool isLowerHexDigit(QChar c)
+{
+    return isDigit(c) || (c.unicode() >= u'a' && c.unicode() <= u'f');
+}
+
+class Tokenizer
+{
+public:
+    explicit Tokenizer(QStringView line)
+        : m_line(line)
+        , m_newline(line.size() - 1)
+    {
+    }
+
+    std::optional<GdbFrameTokens> run()
+    {
+        if (m_line.isEmpty() || m_line.front() != QLatin1Char('#') || m_line.back() != QLatin1Char('\n')) {
+            return std::nullopt;
+        }
+
+        const qsizetype numberEnd = skip(1, isDigit);
+        const qsizetype afterNumber = skip(numberEnd, isSpace);
+        if (numberEnd == 1 || afterNumber == numberEnd) {
+            return std::nullopt;
+        }
+
+        GdbFrameTokens tokens;
+        const qsizetype closing = findArgumentsEnd(tokens);
+        if (closing < 0) {
+            return std::nullopt;
+        }
+        tokens.frameNumber = m_line.sliced(1, numberEnd - 1).toInt();
+
+        // " 0x0000dead in " (optionally)
+        if (startsWith(afterNumber, QLatin1String("0x"))) {
+            const qsizetype hexEnd = skip(afterNumber + 2, isLowerHexDigit);
+            const qsizetype inStart = skip(hexEnd, isSpace);
+            if (hexEnd > afterNumber + 2 && inStart > hexEnd && startsWith(inStart, QLatin1String("in"))) {
+                const qsizetype functionStart = skip(inStart + 2, isSpace);
+                if (functionStart > inStart + 2 && scanFunction(functionStart, functionStart - (inStart + 2), closing, tokens)) {
+                    return tokens;
+                }
+            }
+        }
+
+        if (scanFunction(afterNumber, afterNumber - numberEnd, closing, tokens)) {
+            return tokens;
+        }
+        return std::nullopt;
+    }
+
+private:
+    template<typename Predicate>
+    qsizetype skip(qsizetype pos, Predicate predicate) const
+    {
+        while (pos < m_line.size() && predicate(m_line[pos])) {
+            ++pos;
+        }
+        return pos;
+    }
+
+    bool startsWith(qsizetype pos, QLatin1String word) const
+    {
+        return pos < m_line.size() && m_line.sliced(pos).startsWith(word);
+    }
+
+    // Checks whether the ')' at closing may end the argument list, i.e. it is followed by either just the trailing
+    // newline or by " from|at <path>\n".
+    bool matchLocation(qsizetype closing, GdbFrameTokens &tokens) const
+    {
+        const qsizetype pos = closing + 1;
+        if (pos == m_newline) {
+            tokens.location = {};
+            tokens.locationKind = GdbFrameTokens::LocationKind::None;
+            return true;
+        }
+
+        const qsizetype keywordStart = skip(pos, isSpace);
+        if (keywordStart == pos) {
+            return false;
+        }
+        qsizetype keywordEnd = -1;
+        if (startsWith(keywordStart, QLatin1String("from"))) {
+            keywordEnd = keywordStart + 4;
+            tokens.locationKind = GdbFrameTokens::LocationKind::From;
+        } else if (startsWith(keywordStart, QLatin1String("at"))) {
+            keywordEnd = keywordStart + 2;
+            tokens.locationKind = GdbFrameTokens::LocationKind::At;
+        } else {
+            return false;
+        }
+
+        // The whitespace is greedy but must leave at least one character of path before the trailing newline.
+        const qsizetype pathStart = std::min(skip(keywordEnd, isSpace), m_newline - 1);
+        if (pathStart <= keywordEnd) {
+            return false;
+        }
+        tokens.location = m_line.sliced(pathStart, m_newline - pathStart);
+        return true;
+    }
+
+    qsizetype findArgumentsEnd(GdbFrameTokens &tokens) const
+    {
+        for (qsizetype pos = m_newline - 1; pos >= 0; --pos) {
+            if (m_line[pos] == QLatin1Char(')') && matchLocation(pos, tokens)) {
+                return pos;
+            }
+        }
+        return -1;
+    }
+
+    // Given a signature "(...)" starting at open, finds the opening parenthesis of the arguments that follow it,
+    // separated by whitespace and an optional "const". Returns -1 if there is none before closing.
+    qsizetype argumentsAfterSignature(qsizetype open, qsizetype closing) const
+    {
+        for (qsizetype pos = closing - 1; pos > open; --pos) {
+            if (m_line[pos] != QLatin1Char(')')) {
+                continue;
+            }
+            qsizetype next = skip(pos + 1, isSpace);
+            if (next == pos + 1) {
+                continue;
+            }
+            if (startsWith(next, QLatin1String("const"))) {
+                const qsizetype afterConst = skip(next + 5, isSpace);
+                if (afterConst == next + 5) {
+                    continue;
+                }
+                next = afterConst;
+            }
+            if (next < closing && m_line[next] == QLatin1Char('(')) {
+                return next;
+            }
+        }
+        return -1;
+    }
+
+    // Scans function name, signature and arguments starting at start. spacesBefore is the amount of whitespace
+    // directly in front of start, a backtracking engine may hand some of it to the function name.
+    bool scanFunction(qsizetype start, qsizetype spacesBefore, qsizetype closing, GdbFrameTokens &tokens) const
+    {
+        if (start >= closing) {
+            return false;
+        }
+
+        qsizetype nameStart = start;
+        if (startsWith(start, ANONYMOUS_NAMESPACE) && start + ANONYMOUS_NAMESPACE.size() < closing
+            && m_line[start + ANONYMOUS_NAMESPACE.size()] != QLatin1Char('(')) {
+            nameStart = start + ANONYMOUS_NAMESPACE.size();
+        }
+
+        if (m_line[nameStart] != QLatin1Char('(')) {
+            const qsizetype nameEnd = m_line.indexOf(QLatin1Char('('), nameStart);
+            if (nameEnd >= 0 && nameEnd < closing) {
+                qsizetype open = argumentsAfterSignature(nameEnd, closing);
+                // [^\(]+ needs at least one character, the trailing whitespace goes to [\s]+
+                if (open < 0 && nameEnd - 1 > nameStart && isSpace(m_line[nameEnd - 1])) {
+                    open = nameEnd;
+                }
+                if (open >= 0) {
+                    tokens.functionName = m_line.sliced(start, nameEnd - start).trimmed();
+                    tokens.arguments = m_line.sliced(open, closing - open + 1);
+                    return true;
+                }
+            }
+            if (nameStart == start) {
+                return false;
+            }
+            // else: the anonymous namespace prefix didn't work out, treat its parenthesis as signature
+        }
+
+        // No function name at all, e.g. "#13 0x00007fe6059971b1 in  () at /usr/lib/libglib-2.0.so.0\n"
+        qsizetype open = argumentsAfterSignature(start, closing);
+        if (open < 0 && spacesBefore >= 2) {
+            open = start;
+        }
+        if (open < 0) {
+            return false;
+        }
+        tokens.functionName = {};
+        tokens.arguments = m_line.sliced(open, closing - open + 1);
+        return true;
+    }
+
+    const QStringView m_line;
+    const qsizetype m_newline;
+};
+} // namespace
+
+std::optional<GdbFrameTokens> tokenizeGdbFrame(QStringView line)
+{
+    return Tokenizer(line).run();
+}
@@ -0,0 +1,39 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QStringView>
+
+#include <optional>
+
+/*!
+ * The pieces of a gdb stack frame line, e.g.
+ * "#5  0x00007f50e99f776f in QWidget::testAttribute_helper (this=0x6e6440,\n    attribute=Qt::WA_WState_Created) at kernel/qwidget.cpp:9081\n"
+ * All members are views into the line that was tokenized.
+ */
+struct GdbFrameTokens {
+    enum class LocationKind {
+        None, // no location information
+        At, // "at foo.cpp:123" (usually a source file, sometimes a library)
+        From, // "from /usr/lib/libfoo.so.1" (always a library)
+    };
+
+    int frameNumber = -1;
+    QStringView functionName; // already trimmed, may be empty
+    QStringView arguments; // including the parentheses
+    QStringView location; // the path after from/at
+    LocationKind locationKind = LocationKind::None;
+};
+
+/*!
+ * Splits a (possibly multi-line, see BacktraceParserGdb::newLine) gdb stack frame line into its tokens.
+ * This is a hand-written replacement for the backtracking regular expression BacktraceLineGdb::parse() used to run
+ * on every line. It accepts exactly the same lines and yields exactly the same captures, but scans the line only
+ * once forward plus once backwards (to find the end of the argument list) and never allocates.
+ *
+ * Returns std::nullopt when the line is not a stack frame.
+ */
+std::optional<GdbFrameTokens> tokenizeGdbFrame(QStringView line);
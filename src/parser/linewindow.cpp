@@ -0,0 +1,356 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "linewindow.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+// A line standing in for lines that were left out
+class MarkerLine : public BacktraceLine
+{
+public:
+    explicit MarkerLine(const QString &text)
+    {
+        setLine(text);
+    }
+};
+
+qsizetype byteSize(const BacktraceLine &line)
+{
+    return line.lineView().size() * qsizetype(sizeof(QChar));
+}
+
+// Whether two lines are the same frame of a recursion, i.e. only differ in frame number and address
+bool isSameFrame(const BacktraceLine &a, const BacktraceLine &b)
+{
+    return a.type() == BacktraceLine::StackFrame && b.type() == BacktraceLine::StackFrame && a.functionId() == b.functionId()
+        && a.libraryId() == b.libraryId() && a.fileNameView() == b.fileNameView();
+}
+
+QString omissionText(qsizetype count)
+{
+    return QStringLiteral("[... %1 lines omitted ...]\n").arg(count);
+}
+
+QString capText(qsizetype count)
+{
+    return QStringLiteral("[... %1 lines of earlier threads omitted ...]\n").arg(count);
+}
+} // namespace
+
+LineWindow::LineWindow(QList<BacktraceLine> &lines, bool withMarkers)
+    : m_lines(lines)
+    , m_withMarkers(withMarkers)
+{
+}
+
+void LineWindow::setLimits(const std::optional<BacktraceParser::StreamingLimits> &limits)
+{
+    m_limits = limits;
+    m_bytes = 0;
+    if (m_limits) {
+        // The caps must leave room for the head, tail and an active cycle of the current thread (plus markers).
+        // The head keeps at least the thread header.
+        BacktraceParser::StreamingLimits &l = *m_limits;
+        l.maxLines = std::max<qsizetype>(l.maxLines, 64);
+        l.headLines = std::clamp<qsizetype>(l.headLines, 1, l.maxLines / 8);
+        l.tailLines = std::clamp<qsizetype>(l.tailLines, 0, l.maxLines / 8);
+        l.maxCycleLength = std::clamp<qsizetype>(l.maxCycleLength, 0, l.maxLines / 8);
+        for (const BacktraceLine &line : std::as_const(m_lines)) {
+            m_bytes += byteSize(line);
+        }
+    }
+    resetSegmentState();
+}
+
+void LineWindow::append(const BacktraceLine &line)
+{
+    if (!m_limits) {
+        m_lines.append(line);
+        return;
+    }
+
+    if (m_cycleActive) {
+        Cycle &cycle = m_cycles.last();
+        const qsizetype phase = m_partialCycle.size();
+        if (isSameFrame(line, m_lines.at(cycle.start + phase))) {
+            if (phase + 1 < cycle.length) {
+                m_partialCycle.append(line);
+                return;
+            }
+            // another complete repetition
+            m_partialCycle.clear();
+            ++cycle.repeats;
+            if (cycle.marker >= 0) {
+                replaceMarker(cycle.marker, cycleText(cycle));
+            }
+            return;
+        }
+        // the recursion ended, the frames matched so far and this line are regular lines again
+        endCycle();
+        append(line);
+        return;
+    }
+
+    appendKept(line);
+}
+
+void LineWindow::startSegment()
+{
+    if (m_cycleActive) {
+        endCycle();
+    }
+    m_segmentStart = m_lines.size();
+    resetSegmentState();
+}
+
+void LineWindow::truncateSegment(qsizetype keep)
+{
+    m_cycleActive = false;
+    m_partialCycle.clear();
+    erase(std::min(m_segmentStart + keep, m_lines.size()), m_lines.size());
+    resetSegmentState();
+}
+
+void LineWindow::finish()
+{
+    if (m_cycleActive) {
+        endCycle();
+    }
+}
+
+QString LineWindow::cycleText(const Cycle &cycle)
+{
+    if (cycle.length == 1) {
+        return QStringLiteral("[... previous frame repeated %1 more times ...]\n").arg(cycle.repeats - 1);
+    }
+    return QStringLiteral("[... previous %1 frames repeated %2 more times ...]\n").arg(cycle.length).arg(cycle.repeats - 1);
+}
+
+void LineWindow::appendKept(const BacktraceLine &line)
+{
+    m_lines.append(line);
+    m_bytes += byteSize(line);
+    if (line.type() == BacktraceLine::StackFrame) {
+        detectCycle();
+    }
+    // compact in chunks, erasing from the middle of the list moves the tail every time
+    compactSegment(m_limits->tailLines, std::max<qsizetype>(m_limits->tailLines / 2, 16));
+    enforceCaps();
+}
+
+void LineWindow::detectCycle()
+{
+    const qsizetype end = m_lines.size();
+    const qsizetype from = std::max(m_windowStart, m_detectFrom);
+    for (qsizetype length = 1; length <= m_limits->maxCycleLength && end - 2 * length >= from; ++length) {
+        bool repeated = true;
+        for (qsizetype i = 0; i < length && repeated; ++i) {
+            repeated = isSameFrame(m_lines.at(end - length + i), m_lines.at(end - 2 * length + i));
+        }
+        if (!repeated) {
+            continue;
+        }
+
+        // keep the first copy, drop the second one
+        erase(end - length, end);
+        Cycle cycle{end - 2 * length, length, 2, -1};
+        if (m_withMarkers) {
+            cycle.marker = m_lines.size();
+            insertMarker(cycle.marker, cycleText(cycle));
+        }
+        m_cycles.append(cycle);
+        m_cycleActive = true;
+        m_detectFrom = m_lines.size();
+        return;
+    }
+}
+
+void LineWindow::endCycle()
+{
+    m_cycleActive = false;
+    const QList<BacktraceLine> partial = std::exchange(m_partialCycle, {});
+    for (const BacktraceLine &line : partial) {
+        append(line);
+    }
+}
+
+void LineWindow::compactSegment(qsizetype keepTail, qsizetype slack)
+{
+    if (m_lines.size() - m_windowStart <= keepTail + slack) {
+        return;
+    }
+
+    // Don't separate a cycle from its marker and keep the active one, it is compared against.
+    qsizetype end = m_lines.size() - keepTail;
+    for (qsizetype index = 0; index < m_cycles.size(); ++index) {
+        const Cycle &cycle = m_cycles.at(index);
+        const qsizetype cycleEnd = cycle.marker >= 0 ? cycle.marker + 1 : cycle.start + cycle.length;
+        const bool active = m_cycleActive && index == m_cycles.size() - 1;
+        if (cycle.start < end && (cycleEnd > end || active)) {
+            end = cycle.start;
+            break;
+        }
+    }
+    if (end <= m_windowStart) {
+        return;
+    }
+
+    qsizetype omitted = end - m_windowStart;
+    auto firstKept = std::find_if(m_cycles.begin(), m_cycles.end(), [end](const Cycle &cycle) {
+        return cycle.start >= end;
+    });
+    for (auto it = m_cycles.begin(); it != firstKept; ++it) {
+        omitted += it->length * (it->repeats - 1) - (it->marker >= 0 ? 1 : 0);
+    }
+    m_cycles.erase(m_cycles.begin(), firstKept);
+
+    erase(m_windowStart, end);
+    m_omitted += omitted;
+    if (m_withMarkers) {
+        if (m_omissionMarker < 0) {
+            const qsizetype index = m_windowStart;
+            insertMarker(index, omissionText(m_omitted));
+            m_omissionMarker = index;
+        } else {
+            replaceMarker(m_omissionMarker, omissionText(m_omitted));
+        }
+    }
+    m_detectFrom = std::max(m_detectFrom, m_windowStart);
+}
+
+bool LineWindow::isOverCaps() const
+{
+    return m_lines.size() > m_limits->maxLines || m_bytes > m_limits->maxBytes;
+}
+
+void LineWindow::enforceCaps()
+{
+    if (!isOverCaps()) {
+        return;
+    }
+    // Earlier threads first, but keep the beginning of the backtrace (e.g. the thread indicator) for as long as possible.
+    thinOut(m_capMarker >= 0 ? m_capMarker + 1 : std::min(m_limits->headLines, m_segmentStart), m_segmentStart);
+    if (isOverCaps()) {
+        thinOut(0, m_segmentStart);
+    }
+    if (isOverCaps()) {
+        compactSegment(0, 0);
+    }
+}
+
+void LineWindow::thinOut(qsizetype from, qsizetype to)
+{
+    // erase the oldest lines of the range until the list fits
+    qsizetype end = from;
+    qsizetype lines = m_lines.size() + (m_withMarkers && m_capMarker < 0 ? 1 : 0);
+    qsizetype bytes = m_bytes;
+    while (end < to && (lines > m_limits->maxLines || bytes > m_limits->maxBytes)) {
+        bytes -= byteSize(m_lines.at(end));
+        if (end != m_capMarker) { // the marker is updated, not removed
+            --lines;
+        }
+        ++end;
+    }
+    if (end == from) {
+        return;
+    }
+
+    const bool markerErased = m_capMarker >= from && m_capMarker < end;
+    m_capOmitted += end - from - (markerErased ? 1 : 0);
+    erase(from, end);
+    if (m_withMarkers) {
+        if (m_capMarker < 0) {
+            insertMarker(from, capText(m_capOmitted));
+            m_capMarker = from;
+        } else {
+            replaceMarker(m_capMarker, capText(m_capOmitted));
+        }
+    }
+}
+
+void LineWindow::resetSegmentState()
+{
+    m_windowStart = m_segmentStart + (m_limits ? m_limits->headLines : 0);
+    m_omissionMarker = -1;
+    m_omitted = 0;
+    m_detectFrom = m_windowStart;
+    m_cycles.clear();
+    m_cycleActive = false;
+    m_partialCycle.clear();
+}
+
+void LineWindow::erase(qsizetype from, qsizetype to)
+{
+    if (from >= to) {
+        return;
+    }
+    if (aboutToErase) {
+        aboutToErase(from, to);
+    }
+    if (m_limits) {
+        for (qsizetype index = from; index < to; ++index) {
+            m_bytes -= byteSize(m_lines.at(index));
+        }
+    }
+    m_lines.remove(from, to - from);
+
+    const qsizetype count = to - from;
+    auto shift = [from, to, count](qsizetype &index) {
+        if (index >= to) {
+            index -= count;
+        } else if (index >= from) {
+            index = from;
+        }
+    };
+    auto shiftMarker = [from, to, count](qsizetype &index) {
+        if (index >= to) {
+            index -= count;
+        } else if (index >= from) {
+            index = -1;
+        }
+    };
+    shift(m_segmentStart);
+    shift(m_windowStart);
+    shift(m_detectFrom);
+    shiftMarker(m_omissionMarker);
+    shiftMarker(m_capMarker);
+    for (Cycle &cycle : m_cycles) {
+        shift(cycle.start);
+        shiftMarker(cycle.marker);
+    }
+}
+
+void LineWindow::insertMarker(qsizetype index, const QString &text)
+{
+    const MarkerLine marker(text);
+    m_lines.insert(index, marker);
+    m_bytes += byteSize(marker);
+
+    auto shift = [index](qsizetype &other) {
+        if (other >= index) {
+            ++other;
+        }
+    };
+    shift(m_segmentStart);
+    shift(m_windowStart);
+    shift(m_detectFrom);
+    shift(m_omissionMarker);
+    shift(m_capMarker);
+    for (Cycle &cycle : m_cycles) {
+        shift(cycle.start);
+        shift(cycle.marker);
+    }
+}
+
+void LineWindow::replaceMarker(qsizetype index, const QString &text)
+{
+    const MarkerLine marker(text);
+    m_bytes += byteSize(marker) - byteSize(m_lines.at(index));
+    m_lines[index] = marker;
+}
@@ -0,0 +1,93 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QList>
+
+#include <functional>
+#include <optional>
+
+#include "backtraceline.h"
+#include "backtraceparser.h"
+
+/*!
+ * Appends lines to a list, keeping it bounded when streaming limits are set (see BacktraceParser::setStreamingLimits()).
+ *
+ * The list is made up of segments (threads). Of every segment the first headLines and the last tailLines lines are kept,
+ * the lines in between are replaced by a marker line. Consecutive repetitions of a cycle of frames, as produced by
+ * infinite recursion, are collapsed into one copy of the cycle followed by a marker line with the repeat count. When the
+ * whole list exceeds maxLines lines or maxBytes bytes, earlier segments are thinned out until it fits again.
+ *
+ * Without limits lines are simply appended.
+ */
+class LineWindow
+{
+public:
+    /*! withMarkers: whether to insert lines describing what was left out. Lists that are only used for rating go without. */
+    LineWindow(QList<BacktraceLine> &lines, bool withMarkers);
+
+    void setLimits(const std::optional<BacktraceParser::StreamingLimits> &limits);
+    bool isBounded() const
+    {
+        return m_limits.has_value();
+    }
+
+    void append(const BacktraceLine &line);
+
+    /*! Lines appended from now on belong to a new segment. */
+    void startSegment();
+    /*! Removes all lines of the current segment but the first keep ones. keep must not exceed headLines. */
+    void truncateSegment(qsizetype keep);
+    /*! Appends the frames held back while waiting for another repetition of a cycle, at the end of the backtrace. */
+    void finish();
+
+    /*! Called with the range [from, to) of the list before it is erased, e.g. to keep parallel lists in sync. */
+    std::function<void(qsizetype from, qsizetype to)> aboutToErase;
+
+private:
+    // A cycle of frames collapsed into its first copy, which is followed by the marker (if any)
+    struct Cycle {
+        qsizetype start = 0;
+        qsizetype length = 0;
+        qsizetype repeats = 0; // copies including the kept one
+        qsizetype marker = -1;
+    };
+
+    static QString cycleText(const Cycle &cycle);
+
+    void appendKept(const BacktraceLine &line);
+    void detectCycle();
+    void endCycle();
+    void compactSegment(qsizetype keepTail, qsizetype slack);
+    void enforceCaps();
+    void thinOut(qsizetype from, qsizetype to);
+    bool isOverCaps() const;
+    void resetSegmentState();
+
+    void erase(qsizetype from, qsizetype to);
+    void insertMarker(qsizetype index, const QString &text);
+    void replaceMarker(qsizetype index, const QString &text);
+
+    QList<BacktraceLine> &m_lines;
+    const bool m_withMarkers;
+    std::optional<BacktraceParser::StreamingLimits> m_limits;
+    qsizetype m_bytes = 0;
+
+    qsizetype m_segmentStart = 0;
+    // first line of the current segment's tail window, behind the head and the omission marker
+    qsizetype m_windowStart = 0;
+    qsizetype m_omissionMarker = -1;
+    qsizetype m_omitted = 0;
+    // cycles are only searched from here on, so that they don't overlap with earlier ones
+    qsizetype m_detectFrom = 0;
+    QList<Cycle> m_cycles; // of the current tail window
+    bool m_cycleActive = false; // whether the last cycle is still repeating
+    QList<BacktraceLine> m_partialCycle; // frames matching the beginning of the active cycle so far
+
+    // marker for the lines thinned out of earlier segments
+    qsizetype m_capMarker = -1;
+    qsizetype m_capOmitted = 0;
+};
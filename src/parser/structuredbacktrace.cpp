@@ -0,0 +1,197 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "structuredbacktrace.h"
+
+#include <QHash>
+
+#include <numeric>
+
+namespace
+{
+const char *ratingName(BacktraceLine::LineRating rating)
+{
+    switch (rating) {
+    case BacktraceLine::MissingEverything:
+        return "MissingEverything";
+    case BacktraceLine::MissingFunction:
+        return "MissingFunction";
+    case BacktraceLine::MissingLibrary:
+        return "MissingLibrary";
+    case BacktraceLine::MissingSourceFile:
+        return "MissingSourceFile";
+    case BacktraceLine::Good:
+        return "Good";
+    case BacktraceLine::InvalidRating:
+        break;
+    }
+    return "InvalidRating";
+}
+
+// Appends string as JSON string literal. Runs of characters that need no escaping are copied in one go.
+void appendString(QByteArray &out, QStringView string)
+{
+    const QByteArray utf8 = string.toUtf8();
+    out += '"';
+    qsizetype runStart = 0;
+    for (qsizetype i = 0; i < utf8.size(); ++i) {
+        const uchar c = utf8.at(i);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        out.append(utf8.constData() + runStart, i - runStart);
+        runStart = i + 1;
+        switch (c) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default: {
+            static const char hexDigits[] = "0123456789abcdef";
+            const char escape[] = {'\\', 'u', '0', '0', hexDigits[c >> 4], hexDigits[c & 0xf]};
+            out.append(escape, sizeof(escape));
+            break;
+        }
+        }
+    }
+    out.append(utf8.constData() + runStart, utf8.size() - runStart);
+    out += '"';
+}
+
+// The line without its trailing newline(s)
+QStringView lineText(const BacktraceLine &line)
+{
+    QStringView text = line.lineView();
+    while (text.endsWith(QLatin1Char('\n'))) {
+        text.chop(1);
+    }
+    return text;
+}
+} // namespace
+
+StructuredBacktrace StructuredBacktrace::fromLines(const QList<BacktraceLine> &lines)
+{
+    StructuredBacktrace backtrace;
+    backtrace.m_lines = lines;
+    QHash<SymbolTable::Id, qsizetype> moduleIndexes;
+
+    auto currentThread = [&backtrace]() -> Thread & {
+        if (backtrace.m_threads.isEmpty()) {
+            backtrace.m_threads.append(Thread()); // frames before (or without) any thread header
+        }
+        return backtrace.m_threads.last();
+    };
+
+    for (const BacktraceLine &line : lines) {
+        switch (line.type()) {
+        case BacktraceLine::ThreadStart:
+            backtrace.m_threads.append(Thread{line, {}, -1});
+            break;
+        case BacktraceLine::KCrash: {
+            Thread &thread = currentThread();
+            if (thread.crashFrame < 0) {
+                thread.crashFrame = thread.frames.size();
+                if (backtrace.m_crashedThread < 0) {
+                    backtrace.m_crashedThread = backtrace.m_threads.size() - 1;
+                }
+            }
+            break;
+        }
+        case BacktraceLine::StackFrame: {
+            qsizetype module = -1;
+            if (line.libraryId() != SymbolTable::EmptyId) {
+                auto it = moduleIndexes.constFind(line.libraryId());
+                if (it == moduleIndexes.cend()) {
+                    it = moduleIndexes.insert(line.libraryId(), backtrace.m_modules.size());
+                    backtrace.m_modules.append(Module{line.libraryNameView().trimmed().toString(), line.libraryId(), false});
+                }
+                module = it.value();
+                if (line.rating() == BacktraceLine::MissingFunction || line.rating() == BacktraceLine::MissingSourceFile) {
+                    backtrace.m_modules[module].missingDebugSymbols = true;
+                }
+            }
+            currentThread().frames.append(Frame{line, module});
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    return backtrace;
+}
+
+QByteArray StructuredBacktrace::toJson() const
+{
+    QByteArray out;
+    out.reserve(256 + 128 * std::accumulate(m_threads.cbegin(), m_threads.cend(), qsizetype(0), [](qsizetype count, const Thread &thread) {
+                    return count + thread.frames.size();
+                }));
+
+    out += "{\"threads\":[";
+    for (qsizetype threadIndex = 0; threadIndex < m_threads.size(); ++threadIndex) {
+        const Thread &thread = m_threads.at(threadIndex);
+        if (threadIndex > 0) {
+            out += ',';
+        }
+        out += '{';
+        if (thread.header.type() == BacktraceLine::ThreadStart) {
+            out += "\"header\":";
+            appendString(out, lineText(thread.header));
+            out += ',';
+        }
+        if (thread.crashFrame >= 0) {
+            out += "\"crashFrame\":";
+            out += QByteArray::number(thread.crashFrame);
+            out += ',';
+        }
+        out += "\"frames\":[";
+        for (qsizetype frameIndex = 0; frameIndex < thread.frames.size(); ++frameIndex) {
+            const Frame &frame = thread.frames.at(frameIndex);
+            if (frameIndex > 0) {
+                out += ',';
+            }
+            out += "{\"number\":";
+            out += QByteArray::number(frame.line.frameNumber());
+            out += ",\"function\":";
+            appendString(out, frame.line.functionNameView());
+            if (!frame.line.fileNameView().isEmpty()) {
+                out += ",\"file\":";
+                appendString(out, frame.line.fileNameView());
+            }
+            if (frame.module >= 0) {
+                out += ",\"module\":";
+                out += QByteArray::number(frame.module);
+            }
+            out += ",\"rating\":\"";
+            out += ratingName(frame.line.rating());
+            out += "\"}";
+        }
+        out += "]}";
+    }
+
+    out += "],\"modules\":[";
+    for (qsizetype moduleIndex = 0; moduleIndex < m_modules.size(); ++moduleIndex) {
+        const Module &module = m_modules.at(moduleIndex);
+        if (moduleIndex > 0) {
+            out += ',';
+        }
+        out += "{\"path\":";
+        appendString(out, module.path);
+        out += ",\"missingDebugSymbols\":";
+        out += module.missingDebugSymbols ? "true" : "false";
+        out += '}';
+    }
+    out += "]}";
+    return out;
+}
@@ -0,0 +1,77 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+#include "backtraceline.h"
+
+/*!
+ * The threads, stack frames and modules (libraries) of a parsed backtrace, for consumers that work with frames rather
+ * than text. Frames share their data with the BacktraceLine objects of the parser, nothing is parsed again.
+ *
+ * The duplicate search (ParseBugBacktraces, DuplicateFinderJob) compares frames and uses this. The backtrace widget
+ * and the report show and send the trace as the debugger wrote it, BacktraceParser::parsedBacktrace() and
+ * simplifiedBacktrace() are made of the very same lines. Going through frames would only rebuild that text and drop
+ * the lines that are neither threads nor frames, so they keep using the text.
+ */
+class StructuredBacktrace
+{
+public:
+    struct Frame {
+        BacktraceLine line; // number, function, file and rating
+        qsizetype module = -1; // index into modules(), -1 if the frame has no library
+    };
+
+    struct Thread {
+        BacktraceLine header; // the ThreadStart line, of type Unknown for traces without thread headers
+        QList<Frame> frames;
+        // index of the first frame below the crash handler, -1 unless this is the crashed thread
+        qsizetype crashFrame = -1;
+    };
+
+    struct Module {
+        QString path;
+        SymbolTable::Id id = SymbolTable::EmptyId;
+        bool missingDebugSymbols = false; // at least one frame of this module lacks function or source information
+    };
+
+    /*! Groups lines as returned by BacktraceParser::parsedBacktraceLines() into threads. */
+    static StructuredBacktrace fromLines(const QList<BacktraceLine> &lines);
+
+    const QList<Thread> &threads() const
+    {
+        return m_threads;
+    }
+    const QList<Module> &modules() const
+    {
+        return m_modules;
+    }
+    /*! The lines the backtrace was built from, including the ones that are neither threads nor frames. */
+    const QList<BacktraceLine> &lines() const
+    {
+        return m_lines;
+    }
+    /*! The thread that crashed (the one with the crash handler), or nullptr if there is none. */
+    const Thread *crashedThread() const
+    {
+        return m_crashedThread < 0 ? nullptr : &m_threads.at(m_crashedThread);
+    }
+
+    /*! Serializes to compact JSON, e.g.
+     * {"threads":[{"header":"Thread 1 (...):","crashFrame":0,"frames":[{"number":2,"function":"foo","file":"foo.cpp:1",
+     * "module":0,"rating":"Good"}]}],"modules":[{"path":"/usr/lib/libfoo.so.1","missingDebugSymbols":false}]}
+     */
+    QByteArray toJson() const;
+
+private:
+    QList<BacktraceLine> m_lines;
+    QList<Thread> m_threads;
+    QList<Module> m_modules;
+    qsizetype m_crashedThread = -1;
+};
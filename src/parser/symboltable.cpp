@@ -0,0 +1,128 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "symboltable.h"
+
+#include <QHash>
+#include <QList>
+#include <QReadWriteLock>
+
+#include <optional>
+
+namespace
+{
+class Table
+{
+public:
+    Table()
+        : m_names{QString()} // EmptyId
+    {
+    }
+
+    // Must be called with the lock held (for reading at least).
+    [[nodiscard]] std::optional<SymbolTable::Id> find(QStringView name, size_t hash) const
+    {
+        const auto [begin, end] = m_index.equal_range(hash);
+        for (auto it = begin; it != end; ++it) {
+            if (m_names.at(it.value()) == name) {
+                return it.value();
+            }
+        }
+        return std::nullopt;
+    }
+
+    QReadWriteLock m_lock;
+    QList<QString> m_names; // indexed by id
+    QMultiHash<size_t, SymbolTable::Id> m_index; // hash of the name -> candidate ids
+};
+
+Table &table()
+{
+    static Table table;
+    return table;
+}
+
+thread_local SymbolTable::Session *t_session = nullptr;
+} // namespace
+
+SymbolTable::Session::Session()
+{
+    Q_ASSERT(!t_session);
+    t_session = this;
+}
+
+SymbolTable::Session::~Session()
+{
+    t_session = nullptr;
+}
+
+SymbolTable::Id SymbolTable::intern(QStringView name)
+{
+    if (name.isEmpty()) {
+        return EmptyId;
+    }
+
+    auto &t = table();
+    const size_t hash = qHash(name);
+
+    if (Session *session = t_session) {
+        const auto [begin, end] = session->m_index.equal_range(hash);
+        for (auto it = begin; it != end; ++it) {
+            if (const Session::Entry &entry = session->m_entries.at(it.value()); entry.name == name) {
+                return entry.id;
+            }
+        }
+
+        std::optional<Id> id;
+        {
+            QReadLocker locker(&t.m_lock);
+            id = t.find(name, hash);
+        }
+        if (!id.has_value()) {
+            id = SessionBit | static_cast<Id>(session->m_sessionIds.size());
+            session->m_sessionIds.append(session->m_entries.size());
+        }
+        session->m_index.insert(hash, session->m_entries.size());
+        session->m_entries.append({name.toString(), id.value()});
+        return id.value();
+    }
+
+    {
+        QReadLocker locker(&t.m_lock);
+        if (const auto id = t.find(name, hash); id.has_value()) {
+            return id.value();
+        }
+    }
+
+    QWriteLocker locker(&t.m_lock);
+    // someone else may have inserted it while we didn't hold the lock
+    if (const auto id = t.find(name, hash); id.has_value()) {
+        return id.value();
+    }
+    const auto id = static_cast<Id>(t.m_names.size());
+    t.m_names.append(name.toString());
+    t.m_index.insert(hash, id);
+    return id;
+}
+
+QString SymbolTable::name(Id id)
+{
+    if (id & SessionBit) {
+        const Session *session = t_session;
+        Q_ASSERT(session);
+        return session ? session->m_entries.at(session->m_sessionIds.value(id & ~SessionBit)).name : QString();
+    }
+
+    auto &t = table();
+    QReadLocker locker(&t.m_lock);
+    return t.m_names.value(id);
+}
+
+qsizetype SymbolTable::size()
+{
+    auto &t = table();
+    QReadLocker locker(&t.m_lock);
+    return t.m_names.size();
+}
@@ -0,0 +1,70 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringView>
+
+/*!
+ * Process-wide interner for the function and library names found in backtraces.
+ * The same handful of names ("QCoreApplication::notify", "libQt6Core.so.6", "??") appear in every trace, interning
+ * them lets lines compare names by id instead of by string. Ids are stable for the lifetime of the process and the
+ * table is safe to use from multiple threads.
+ *
+ * Backtraces that are only looked at for a while (e.g. the ones in bug comments) are parsed in a Session, so that
+ * their names don't pile up in the table for the lifetime of the process.
+ */
+class SymbolTable
+{
+public:
+    using Id = quint32;
+    /*! The id of the empty (and null) string. */
+    static constexpr Id EmptyId = 0;
+
+    /*! Returns the id of name, adding it to the table if it wasn't known yet. Lookups do not allocate. */
+    static Id intern(QStringView name);
+
+    /*! Returns the name for an id previously returned by intern(). */
+    static QString name(Id id);
+
+    /*! Returns the amount of distinct names in the process-wide table. */
+    static qsizetype size();
+
+    /*!
+     * While a session lives, names interned on its thread that aren't in the process-wide table are added to the
+     * session instead and forgotten with it. Names already in the table keep their ids, so lines interned before (e.g.
+     * of our own backtrace) compare with the session's as usual. Known names are remembered by the session too,
+     * looking them up again doesn't lock the table.
+     * Ids of a session are only valid on its thread and for as long as it lives. There is one session per thread at most.
+     */
+    class Session
+    {
+    public:
+        Session();
+        ~Session();
+
+    private:
+        friend class SymbolTable;
+        struct Entry {
+            QString name;
+            Id id;
+        };
+
+        QList<Entry> m_entries;
+        QMultiHash<size_t, qsizetype> m_index; // hash of the name -> candidate entries
+        QList<qsizetype> m_sessionIds; // entry of every id of the session, indexed by the id without SessionBit
+
+        Q_DISABLE_COPY_MOVE(Session)
+    };
+
+private:
+    // Set on the ids of names that belong to a session rather than the process-wide table.
+    static constexpr Id SessionBit = Id(1) << 31;
+
+    SymbolTable() = delete;
+};
@@ -63,7 +63,9 @@ Kirigami.ScrollablePage {
                 contentItem: Kirigami.IconTitleSubtitle {
                     icon.name: reportInterface.attachToBugNumber === ROLE_Number ? "document-duplicate" : ""
                     title: ROLE_Title
-                    subtitle: ROLE_Number
+                    subtitle: ROLE_Similarity >= 0
+                        ? i18nc("@label bug number and how similar its backtrace is to the crash's backtrace", "%1 (backtrace %2% similar)", ROLE_Number, Math.round(ROLE_Similarity * 100))
+                        : ROLE_Number
                 }
 
                 actions: [
@@ -51,6 +51,8 @@ QVariant DuplicateModel::data(const QModelIndex &index, int intRole) const
         return bug->id();
     case Role::Object:
         return QVariant::fromValue(bug.data());
+    case Role::Similarity:
+        return m_similarities.value(bug->id(), -1.0);
     }
 
     return {};
@@ -93,6 +95,7 @@ void DuplicateModel::searchFinished(const QList<Bugzilla::Bug::Ptr> &list)
             Q_EMIT searchingChanged();
             auto *job = new DuplicateFinderJob(list, m_manager, this);
             connect(job, &KJob::result, this, &DuplicateModel::analyzedDuplicates);
+            connect(job, &DuplicateFinderJob::similarityScored, this, &DuplicateModel::similarityScored);
             job->start();
         }
     } else {
@@ -117,4 +120,16 @@ void DuplicateModel::analyzedDuplicates(KJob *j)
     Q_EMIT searchingChanged();
 }
 
+void DuplicateModel::similarityScored(int bugId, double similarity)
+{
+    m_similarities.insert(bugId, similarity);
+    for (int row = 0; row < m_list.size(); ++row) {
+        if (m_list.at(row)->id() == bugId) {
+            const QModelIndex changed = index(row);
+            Q_EMIT dataChanged(changed, changed, {static_cast<int>(Role::Similarity)});
+            return;
+        }
+    }
+}
+
 #include "moc_duplicatemodel.cpp"
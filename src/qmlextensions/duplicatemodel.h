@@ -21,6 +21,7 @@ public:
         Title = Qt::UserRole + 1,
         Number,
         Object,
+        Similarity, // how similar the bug's backtraces are to ours, 0 to 1, or -1 if not known (yet)
     };
     Q_ENUM(Role)
 
@@ -47,6 +48,7 @@ public:
 private:
     void searchFinished(const QList<Bugzilla::Bug::Ptr> &list);
     void analyzedDuplicates(KJob *j);
+    void similarityScored(int bugId, double similarity);
 
     int m_offset = 0;
     bool m_atEnd = false;
@@ -54,4 +56,5 @@ private:
     bool m_searching = false;
     int m_foundDuplicate = false;
     DuplicateFinderJob::Result m_result;
+    QHash<int, double> m_similarities;
 };
@@ -0,0 +1,98 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QSettings>
+#include <QTest>
+
+#define DATA_DIR QFINDTESTDATA("backtraceparsertest_data")
+
+// Runs the installed drkonqi-backtrace-analyzer over the parser test data, its ratings must be those of the parser.
+class BacktraceAnalyzerTest : public QObject
+{
+    Q_OBJECT
+private:
+    static QList<QJsonObject> analyze(const QStringList &arguments, int expectedExitCode)
+    {
+        QProcess process;
+        process.setProgram(QStringLiteral(ANALYZER_EXECUTABLE));
+        process.setArguments(arguments);
+        process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+        process.start();
+        if (!process.waitForFinished()) {
+            qWarning() << process.errorString();
+            return {};
+        }
+        if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != expectedExitCode) {
+            qWarning() << "unexpected exit" << process.exitStatus() << process.exitCode();
+            return {};
+        }
+
+        QList<QJsonObject> results;
+        const QList<QByteArray> lines = process.readAllStandardOutput().split('\n');
+        for (const QByteArray &line : lines) {
+            if (!line.isEmpty()) {
+                results << QJsonDocument::fromJson(line).object();
+            }
+        }
+        return results;
+    }
+
+private Q_SLOTS:
+    void testRatings()
+    {
+        QSettings settings(DATA_DIR + QStringLiteral("/data.ini"), QSettings::IniFormat);
+        settings.beginGroup(QStringLiteral("usefulness"));
+        const QStringList keys = settings.childKeys();
+        QVERIFY(!keys.isEmpty());
+
+        QStringList files;
+        for (const QString &key : keys) {
+            files << DATA_DIR + QLatin1Char('/') + key;
+        }
+        const QList<QJsonObject> results = analyze(QStringList{QStringLiteral("--jobs"), QStringLiteral("4")} + files, 0);
+
+        // one result per file, in input order, even though they are parsed in parallel
+        QCOMPARE(results.size(), files.size());
+        for (qsizetype i = 0; i < files.size(); ++i) {
+            QCOMPARE(results.at(i).value(QStringLiteral("file")).toString(), files.at(i));
+            QCOMPARE(results.at(i).value(QStringLiteral("usefulness")).toString(), settings.value(keys.at(i)).toString());
+            QVERIFY(results.at(i).value(QStringLiteral("firstValidFunctions")).isArray());
+        }
+    }
+
+    void testFirstValidFunctions()
+    {
+        const QString file = DATA_DIR + QStringLiteral("/test_usefulfunctions");
+        const QList<QJsonObject> results = analyze({file}, 0);
+
+        QCOMPARE(results.size(), 1);
+        QStringList functions;
+        const QJsonArray array = results.constFirst().value(QStringLiteral("firstValidFunctions")).toArray();
+        for (const auto &function : array) {
+            functions << function.toString();
+        }
+        QCOMPARE(functions.join(QLatin1Char('|')), QStringLiteral("SqlQueryMaker::handleTracks|SqlQueryMaker::handleResult|SqlWorkerThread::run"));
+    }
+
+    void testMissingInput()
+    {
+        // a missing input fails the run, the other inputs are still analyzed
+        const QString file = DATA_DIR + QStringLiteral("/test_a");
+        const QList<QJsonObject> results = analyze({DATA_DIR + QStringLiteral("/does_not_exist"), file}, 1);
+
+        QCOMPARE(results.size(), 1);
+        QCOMPARE(results.constFirst().value(QStringLiteral("file")).toString(), file);
+        QCOMPARE(results.constFirst().value(QStringLiteral("usefulness")).toString(), QStringLiteral("Useless"));
+    }
+};
+
+QTEST_GUILESS_MAIN(BacktraceAnalyzerTest)
+
+#include "backtraceanalyzertest.moc"
@@ -0,0 +1,204 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "../../parser/backtraceparser.h"
+#include "../../parser/backtraceparsergdb.h"
+#include "fakebacktracegenerator.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTest>
+#include <QTextStream>
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#include <sys/resource.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#define DATA_DIR QFINDTESTDATA("backtraceparsertest_data")
+
+namespace
+{
+// Counts the calls of operator new while enabled, on all threads. The array and nothrow forms end up in the replaced
+// operator new as well. Qt's containers (and with them QString) allocate with malloc and aren't counted, the heap held
+// tells about those.
+std::atomic<bool> s_countAllocations = false;
+std::atomic<qint64> s_allocations = 0;
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    if (s_countAllocations.load(std::memory_order_relaxed)) {
+        s_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void *pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+namespace
+{
+// Peak resident set size of the process so far, i.e. of the largest backtrace parsed up to now.
+qint64 peakResidentKiB()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Heap in use, to tell the memory the parser holds on to. Only available with glibc.
+qint64 heapInUseKiB()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return qint64(mallinfo2().uordblks / 1024);
+#else
+    return -1;
+#endif
+}
+
+QStringList readLines(const QString &filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return {};
+    }
+    QTextStream stream(&file);
+    QStringList lines;
+    while (!stream.atEnd()) {
+        lines << stream.readLine() + QLatin1Char('\n');
+    }
+    return lines;
+}
+
+// A "thread apply all bt" of an application with many threads. The crashing thread comes last, with KCrash frames
+// above the signal handler. templateDepth nests template arguments to produce the multi kilobyte function names
+// heavily templated code has.
+QStringList syntheticTrace(int threads, int frames, int templateDepth)
+{
+    QString type = QStringLiteral("int");
+    for (int i = 0; i < templateDepth; ++i) {
+        type = QStringLiteral("std::map<QString, std::vector<std::shared_ptr<%1>>>").arg(type);
+    }
+
+    QStringList lines;
+    lines << QStringLiteral("[Current thread is 1 (Thread 0x7f468b0c8940 (LWP 1000))]\n");
+    for (int thread = threads; thread >= 1; --thread) {
+        lines << QStringLiteral("\n");
+        lines << QStringLiteral("Thread %1 (Thread 0x7f468b%2 (LWP %3)):\n")
+                     .arg(QString::number(thread), QStringLiteral("%1").arg(thread, 6, 16, QLatin1Char('0')), QString::number(1000 + thread));
+        int number = 0;
+        if (thread == 1) {
+            lines << QStringLiteral("#0  0x00007f468f4a6f2f in KCrash::defaultCrashHandler (sig=11) at /usr/src/debug/kcrash/src/kcrash.cpp:610\n");
+            lines << QStringLiteral("#1  <signal handler called>\n");
+            number = 2;
+        }
+        for (int frame = 0; frame < frames; ++frame, ++number) {
+            const QString address = QStringLiteral("%1").arg(0x1000 + frame * 16, 8, 16, QLatin1Char('0'));
+            if (frame % 5 == 4) {
+                // a frame without debug symbols
+                lines << QStringLiteral("#%1  0x00007f46%2 in ?? () from /usr/lib64/libKFoo%3.so.6\n").arg(QString::number(number), address, QString::number(frame % 3));
+                continue;
+            }
+            // gdb wraps long frames, the continuation is indented
+            lines << QStringLiteral("#%1  0x00007f46%2 in KFoo::Worker%3<%4>::run (this=0x55d0c8e0a2b0, value=...,\n")
+                         .arg(QString::number(number), address, QString::number(frame % 7), type);
+            lines << QStringLiteral("    flags=...) at /usr/src/debug/kfoo/src/worker%1.cpp:%2\n").arg(QString::number(frame % 7), QString::number(100 + frame));
+        }
+        lines << QStringLiteral("#%1  0x00007f468e494e2d in start_thread (arg=<optimized out>) at pthread_create.c:442\n").arg(QString::number(number));
+    }
+    return lines;
+}
+} // namespace
+
+class BacktraceParserBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkParser_data()
+    {
+        QTest::addColumn<QString>("debugger");
+        QTest::addColumn<bool>("parallel");
+        QTest::addColumn<QStringList>("lines");
+
+        QList<std::pair<QString, QStringList>> inputs;
+        const QDir dataDir(DATA_DIR);
+        const QStringList files = dataDir.entryList({QStringLiteral("test_*")}, QDir::Files, QDir::Name);
+        for (const QString &file : files) {
+            inputs.append({file, readLines(dataDir.filePath(file))});
+        }
+        inputs.append({QStringLiteral("synthetic 100x50"), syntheticTrace(100, 50, 0)});
+        inputs.append({QStringLiteral("synthetic 200x100 templates"), syntheticTrace(200, 100, 4)});
+
+        const QStringList debuggers{QStringLiteral("gdb"), QStringLiteral("lldb"), QStringLiteral("cdb"), QStringLiteral("kdbgwin")};
+        for (const auto &[name, lines] : std::as_const(inputs)) {
+            for (const QString &debugger : debuggers) {
+                QTest::addRow("%s/%s", qPrintable(debugger), qPrintable(name)) << debugger << true << lines;
+            }
+            QTest::addRow("gdb serial/%s", qPrintable(name)) << QStringLiteral("gdb") << false << lines;
+        }
+    }
+
+    void benchmarkParser()
+    {
+        QFETCH(QString, debugger);
+        QFETCH(bool, parallel);
+        QFETCH(QStringList, lines);
+
+        FakeBacktraceGenerator generator;
+        auto newParser = [&] {
+            std::unique_ptr<BacktraceParser> parser(BacktraceParser::newParser(debugger));
+            if (auto gdbParser = qobject_cast<BacktraceParserGdb *>(parser.get()); gdbParser && !parallel) {
+                gdbParser->setThreadPool(nullptr);
+            }
+            parser->connectToGenerator(&generator);
+            generator.sendLines(lines);
+            // rating is part of the job
+            parser->backtraceUsefulness();
+            return parser;
+        };
+
+        // One instrumented run for the numbers QBENCHMARK doesn't report
+        QElapsedTimer timer;
+        const qint64 heapBefore = heapInUseKiB();
+        s_allocations = 0;
+        s_countAllocations = true;
+        timer.start();
+        const std::unique_ptr<BacktraceParser> parser = newParser();
+        const qint64 nsecs = timer.nsecsElapsed();
+        s_countAllocations = false;
+        const qint64 heapAfter = heapInUseKiB();
+
+        const double linesPerSecond = nsecs > 0 ? lines.size() * 1e9 / double(nsecs) : 0;
+        qInfo().noquote() << QTest::currentDataTag() << "lines:" << lines.size() << "lines/s:" << qint64(linesPerSecond)
+                          << "operator new calls:" << s_allocations.load()
+                          << "heap held KiB:" << (heapBefore < 0 ? -1 : heapAfter - heapBefore) << "peak RSS KiB:" << peakResidentKiB();
+
+        QBENCHMARK {
+            newParser();
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(BacktraceParserBenchmark)
+
+#include "backtraceparserbenchmark.moc"
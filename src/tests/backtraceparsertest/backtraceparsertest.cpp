@@ -5,11 +5,42 @@
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 #include "backtraceparsertest.h"
+#include "../../parser/backtraceparsergdb.h"
 #include <QMetaEnum>
 #include <QSharedPointer>
+#include <QThreadPool>
 
 #define DATA_DIR QFINDTESTDATA("backtraceparsertest_data")
 
+namespace
+{
+// The crashing thread of an infinite recursion through a cycle of three functions, depth frames deep
+QStringList recursionTrace(int depth)
+{
+    QStringList lines;
+    lines << QStringLiteral("[Current thread is 1 (Thread 0x7f468b0c8940 (LWP 1000))]\n");
+    lines << QStringLiteral("\n");
+    lines << QStringLiteral("Thread 2 (Thread 0x7f468b0c9940 (LWP 1001)):\n");
+    lines << QStringLiteral("#0  0x00007f468e4f3d2d in poll () from /lib64/libc.so.6\n");
+    lines << QStringLiteral("#1  0x00007f468e494e2d in start_thread (arg=<optimized out>) at pthread_create.c:442\n");
+    lines << QStringLiteral("\n");
+    lines << QStringLiteral("Thread 1 (Thread 0x7f468b0c8940 (LWP 1000)):\n");
+    lines << QStringLiteral("#0  0x00007f468f4a6f2f in KCrash::defaultCrashHandler (sig=11) at /usr/src/debug/kcrash/src/kcrash.cpp:610\n");
+    lines << QStringLiteral("#1  <signal handler called>\n");
+    static const char *const functions[] = {"KFoo::Node::visit", "KFoo::Node::visitChildren", "KFoo::Visitor::accept"};
+    int number = 2;
+    for (int frame = 0; frame < depth; ++frame, ++number) {
+        lines << QStringLiteral("#%1  0x00007f46%2 in %3 (this=0x55d0c8e0a2b0) at /usr/src/debug/kfoo/src/node.cpp:%4\n")
+                     .arg(QString::number(number),
+                          QStringLiteral("%1").arg(0x1000 + frame % 3 * 16, 8, 16, QLatin1Char('0')),
+                          QLatin1String(functions[frame % 3]),
+                          QString::number(100 + frame % 3));
+    }
+    lines << QStringLiteral("#%1  0x00007f468f0a1234 in main (argc=1, argv=0x7ffd4e5f6a88) at /usr/src/debug/kfoo/src/main.cpp:12\n").arg(number);
+    return lines;
+}
+} // namespace
+
 BacktraceParserTest::BacktraceParserTest(QObject *parent)
     : QObject(parent)
     , m_settings(DATA_DIR + QLatin1Char('/') + QStringLiteral("data.ini"), QSettings::IniFormat)
@@ -126,6 +157,178 @@ void BacktraceParserTest::btParserCompositorCrashTest()
     QCOMPARE(parser->hasCompositorCrashed(), compositorCrash);
 }
 
+void BacktraceParserTest::btParserRatingUpdatesTest_data()
+{
+    fetchData(QStringLiteral("usefulness"));
+}
+
+void BacktraceParserTest::btParserRatingUpdatesTest()
+{
+    QFETCH(QString, filename);
+    QFETCH(QString, debugger);
+
+    QSharedPointer<BacktraceParser> parser(BacktraceParser::newParser(debugger));
+    parser->connectToGenerator(m_generator);
+
+    // record what listeners get to see while the trace streams in
+    QList<BacktraceParser::Usefulness> usefulnessUpdates;
+    QStringList functionsUpdates;
+    connect(parser.data(), &BacktraceParser::ratingDataChanged, this, [&usefulnessUpdates, &functionsUpdates, &parser] {
+        usefulnessUpdates.append(parser->backtraceUsefulness());
+        functionsUpdates.append(parser->firstValidFunctions().join(QLatin1Char('|')));
+    });
+    m_generator->sendData(filename);
+
+    // there always is a final verdict, and the last update matches what a query after the fact returns
+    QVERIFY(!usefulnessUpdates.isEmpty());
+    QVERIFY(!usefulnessUpdates.contains(BacktraceParser::InvalidUsefulness));
+    QCOMPARE(usefulnessUpdates.constLast(), parser->backtraceUsefulness());
+    QCOMPARE(functionsUpdates.constLast(), parser->firstValidFunctions().join(QLatin1Char('|')));
+}
+
+void BacktraceParserTest::btParserParallelTest_data()
+{
+    btParserBenchmark_data();
+}
+
+void BacktraceParserTest::btParserParallelTest()
+{
+    QFETCH(QString, filename);
+    QFETCH(QString, debugger);
+    if (debugger != QLatin1String("gdb")) {
+        QSKIP("only the gdb parser parses in parallel");
+    }
+
+    auto parse = [this, &filename](QThreadPool *pool) {
+        QSharedPointer<BacktraceParserGdb> parser(new BacktraceParserGdb);
+        parser->setThreadPool(pool);
+        parser->connectToGenerator(m_generator);
+        m_generator->sendData(filename);
+        m_generator->disconnect(parser.data());
+        return parser;
+    };
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+    const QSharedPointer<BacktraceParserGdb> serial = parse(nullptr);
+    const QSharedPointer<BacktraceParserGdb> parallel = parse(&pool);
+
+    QCOMPARE(parallel->parsedBacktrace(), serial->parsedBacktrace());
+    QCOMPARE(parallel->informationLines(), serial->informationLines());
+    QCOMPARE(parallel->backtraceUsefulness(), serial->backtraceUsefulness());
+    QCOMPARE(parallel->simplifiedBacktrace(), serial->simplifiedBacktrace());
+    QCOMPARE(parallel->firstValidFunctions(), serial->firstValidFunctions());
+    QCOMPARE(parallel->librariesWithMissingDebugSymbols(), serial->librariesWithMissingDebugSymbols());
+
+    const QList<BacktraceLine> serialLines = serial->parsedBacktraceLines();
+    const QList<BacktraceLine> parallelLines = parallel->parsedBacktraceLines();
+    QCOMPARE(parallelLines.size(), serialLines.size());
+    for (qsizetype i = 0; i < serialLines.size(); ++i) {
+        QCOMPARE(parallelLines.at(i).type(), serialLines.at(i).type());
+        QCOMPARE(parallelLines.at(i).rating(), serialLines.at(i).rating());
+        QCOMPARE(parallelLines.at(i).functionId(), serialLines.at(i).functionId());
+        QCOMPARE(parallelLines.at(i).libraryName(), serialLines.at(i).libraryName());
+        QCOMPARE(parallelLines.at(i).fileName(), serialLines.at(i).fileName());
+    }
+}
+
+void BacktraceParserTest::btParserParallelRatingTest_data()
+{
+    fetchData(QStringLiteral("usefulness"));
+}
+
+void BacktraceParserTest::btParserParallelRatingTest()
+{
+    QFETCH(QString, filename);
+    QFETCH(QString, debugger);
+    if (debugger != QLatin1String("gdb")) {
+        QSKIP("only the gdb parser parses in parallel");
+    }
+
+    auto parse = [this, &filename](QThreadPool *pool) {
+        QSharedPointer<BacktraceParserGdb> parser(new BacktraceParserGdb);
+        parser->setThreadPool(pool);
+        parser->connectToGenerator(m_generator);
+        m_generator->sendData(filename);
+        m_generator->disconnect(parser.data());
+        return parser;
+    };
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+    const QSharedPointer<BacktraceParserGdb> serial = parse(nullptr);
+    const QSharedPointer<BacktraceParserGdb> parallel = parse(&pool);
+
+    // the rating is asked for before the text, it must already cover all blocks
+    QCOMPARE(parallel->backtraceUsefulness(), serial->backtraceUsefulness());
+    QCOMPARE(parallel->firstValidFunctions(), serial->firstValidFunctions());
+    QCOMPARE(parallel->simplifiedBacktrace(), serial->simplifiedBacktrace());
+    QCOMPARE(parallel->librariesWithMissingDebugSymbols(), serial->librariesWithMissingDebugSymbols());
+    QCOMPARE(parallel->hasCompositorCrashed(), serial->hasCompositorCrashed());
+    QCOMPARE(parallel->parsedBacktrace(), serial->parsedBacktrace());
+}
+
+void BacktraceParserTest::btParserStreamingTest_data()
+{
+    fetchData(QStringLiteral("usefulness"));
+}
+
+void BacktraceParserTest::btParserStreamingTest()
+{
+    QFETCH(QString, filename);
+    QFETCH(QString, debugger);
+
+    // ordinary backtraces fit into the windows, the rating must not change
+    auto parse = [this, &filename, &debugger](const std::optional<BacktraceParser::StreamingLimits> &limits) {
+        QSharedPointer<BacktraceParser> parser(BacktraceParser::newParser(debugger));
+        parser->setStreamingLimits(limits);
+        parser->connectToGenerator(m_generator);
+        m_generator->sendData(filename);
+        m_generator->disconnect(parser.data());
+        return parser;
+    };
+    const QSharedPointer<BacktraceParser> unbounded = parse(std::nullopt);
+    const QSharedPointer<BacktraceParser> bounded = parse(BacktraceParser::StreamingLimits());
+
+    QCOMPARE(bounded->backtraceUsefulness(), unbounded->backtraceUsefulness());
+    QCOMPARE(bounded->firstValidFunctions(), unbounded->firstValidFunctions());
+    QCOMPARE(bounded->simplifiedBacktrace(), unbounded->simplifiedBacktrace());
+}
+
+void BacktraceParserTest::btParserStreamingRecursionTest()
+{
+    BacktraceParser::StreamingLimits limits;
+    limits.maxLines = 1000;
+
+    auto parse = [this](const QStringList &lines, const std::optional<BacktraceParser::StreamingLimits> &limits) {
+        QSharedPointer<BacktraceParser> parser(BacktraceParser::newParser(QStringLiteral("gdb")));
+        parser->setStreamingLimits(limits);
+        parser->connectToGenerator(m_generator);
+        m_generator->sendLines(lines);
+        m_generator->disconnect(parser.data());
+        return parser;
+    };
+    const QSharedPointer<BacktraceParser> unbounded = parse(recursionTrace(3000), std::nullopt);
+    const QSharedPointer<BacktraceParser> shallow = parse(recursionTrace(3000), limits);
+    const QSharedPointer<BacktraceParser> deep = parse(recursionTrace(300000), limits);
+
+    // the recursion collapses into one cycle, so the size doesn't depend on the depth
+    const QList<BacktraceLine> shallowLines = shallow->parsedBacktraceLines();
+    QVERIFY(shallowLines.size() <= limits.maxLines);
+    QCOMPARE(deep->parsedBacktraceLines().size(), shallowLines.size());
+
+    const QString text = deep->parsedBacktrace();
+    QVERIFY(text.contains(QLatin1String("[... previous 3 frames repeated")));
+    QVERIFY(text.contains(QLatin1String("[KCrash Handler]")));
+    QVERIFY(text.contains(QLatin1String("Thread 2 (Thread 0x7f468b0c9940 (LWP 1001)):")));
+    QVERIFY(text.contains(QLatin1String(" in main (argc=1")));
+
+    // rating and the simplified backtrace still work
+    QCOMPARE(deep->backtraceUsefulness(), unbounded->backtraceUsefulness());
+    QCOMPARE(deep->firstValidFunctions(), unbounded->firstValidFunctions());
+    QCOMPARE(deep->simplifiedBacktrace(), unbounded->simplifiedBacktrace());
+}
+
 QTEST_GUILESS_MAIN(BacktraceParserTest)
 
 #include "moc_backtraceparsertest.cpp"
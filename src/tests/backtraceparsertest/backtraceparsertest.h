@@ -27,6 +27,15 @@ private Q_SLOTS:
     void btParserBenchmark();
     void btParserCompositorCrashTest_data();
     void btParserCompositorCrashTest();
+    void btParserRatingUpdatesTest_data();
+    void btParserRatingUpdatesTest();
+    void btParserParallelTest_data();
+    void btParserParallelTest();
+    void btParserParallelRatingTest_data();
+    void btParserParallelRatingTest();
+    void btParserStreamingTest_data();
+    void btParserStreamingTest();
+    void btParserStreamingRecursionTest();
 
 private:
     void fetchData(const QString &group);
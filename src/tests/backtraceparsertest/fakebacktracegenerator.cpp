@@ -20,4 +20,13 @@ void FakeBacktraceGenerator::sendData(const QString &filename)
     Q_EMIT newLine(QString());
 }
 
+void FakeBacktraceGenerator::sendLines(const QStringList &lines)
+{
+    Q_EMIT starting();
+    for (const QString &line : lines) {
+        Q_EMIT newLine(line);
+    }
+    Q_EMIT newLine(QString());
+}
+
 #include "moc_fakebacktracegenerator.cpp"
@@ -18,6 +18,8 @@ public:
     {
     }
     void sendData(const QString &filename);
+    /*! Sends lines that were read before, each including its trailing newline. */
+    void sendLines(const QStringList &lines);
 
 Q_SIGNALS:
     void starting();
@@ -0,0 +1,113 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QTest>
+
+#include "../parser/backtracesimilarity.h"
+
+namespace
+{
+// One frame per character, e.g. "abc"
+BacktraceSimilarity::Frames frames(const char *names)
+{
+    BacktraceSimilarity::Frames result;
+    for (const char *name = names; *name; ++name) {
+        result.append(SymbolTable::intern(QString(QLatin1Char(*name))));
+    }
+    return result;
+}
+} // namespace
+
+class BacktraceSimilarityTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testBounds()
+    {
+        const BacktraceSimilarity similarity(frames("abcdef"));
+        QCOMPARE(similarity.score(frames("abcdef")), 1.0);
+        QCOMPARE(similarity.score(frames("uvwxyz")), 0.0);
+        QCOMPARE(similarity.score({}), 0.0);
+        QCOMPARE(BacktraceSimilarity({}).score(frames("abc")), 0.0);
+    }
+
+    void testInlinedFrame()
+    {
+        // an extra frame in the middle costs less than a different one
+        const BacktraceSimilarity similarity(frames("abcdef"));
+        const double inlined = similarity.score(frames("abcXdef"));
+        const double different = similarity.score(frames("abcXef"));
+        QVERIFY(inlined > 0.9);
+        QVERIFY(inlined > different);
+    }
+
+    void testShiftedFrames()
+    {
+        // a missing top frame shifts all others, they still match
+        const BacktraceSimilarity similarity(frames("abcdef"));
+        QVERIFY(similarity.score(frames("bcdef")) > 0.8);
+    }
+
+    void testPositionWeighting()
+    {
+        // differences at the top of the stack weigh more than at the bottom
+        const BacktraceSimilarity similarity(frames("abcdefgh"));
+        QVERIFY(similarity.score(frames("abcdefgX")) > similarity.score(frames("Xbcdefgh")));
+    }
+
+    void testSymmetric()
+    {
+        const BacktraceSimilarity ab(frames("abcdXf"));
+        const BacktraceSimilarity ba(frames("abYcdef"));
+        QVERIFY(qFuzzyCompare(ab.score(frames("abYcdef")), ba.score(frames("abcdXf"))));
+    }
+
+    void testLongestCommonSubsequence_data()
+    {
+        QTest::addColumn<QByteArray>("query");
+        QTest::addColumn<QByteArray>("candidate");
+        QTest::addColumn<qsizetype>("length");
+
+        QTest::newRow("equal") << QByteArray("abcdef") << QByteArray("abcdef") << qsizetype(6);
+        QTest::newRow("disjoint") << QByteArray("abc") << QByteArray("xyz") << qsizetype(0);
+        QTest::newRow("interleaved") << QByteArray("abcbdab") << QByteArray("bdcaba") << qsizetype(4);
+        QTest::newRow("repeated") << QByteArray("aaaa") << QByteArray("aa") << qsizetype(2);
+        QTest::newRow("empty") << QByteArray("abc") << QByteArray() << qsizetype(0);
+    }
+
+    void testLongestCommonSubsequence()
+    {
+        QFETCH(QByteArray, query);
+        QFETCH(QByteArray, candidate);
+        QFETCH(qsizetype, length);
+        QCOMPARE(BacktraceSimilarity(frames(query.constData())).longestCommonSubsequence(frames(candidate.constData())), length);
+    }
+
+    void testMinimumScore()
+    {
+        // candidates that can't reach the minimum are skipped, the others are scored as usual
+        const BacktraceSimilarity similarity(frames("abcdefgh"));
+        QCOMPARE(similarity.score(frames("stuvwxyz"), 0.5), 0.0);
+        QCOMPARE(similarity.score(frames("abcdefgX"), 0.5), similarity.score(frames("abcdefgX")));
+    }
+
+    void testMaxFrames()
+    {
+        // only the top frames are compared, a deep recursion doesn't make the score more expensive
+        BacktraceSimilarity::Frames deep = frames("abc");
+        const BacktraceSimilarity::Frames recursion = frames("r");
+        for (int i = 0; i < 1000; ++i) {
+            deep += recursion;
+        }
+        const BacktraceSimilarity similarity(deep);
+        QCOMPARE(similarity.score(deep), 1.0);
+        QCOMPARE(similarity.longestCommonSubsequence(deep), BacktraceSimilarity::MaxFrames);
+    }
+};
+
+QTEST_GUILESS_MAIN(BacktraceSimilarityTest)
+
+#include "backtracesimilaritytest.moc"
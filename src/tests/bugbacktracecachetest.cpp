@@ -0,0 +1,126 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <optional>
+
+#include "../bugzillaintegration/bugbacktracecache.h"
+#include "../parser/backtraceparsergdb.h"
+
+namespace
+{
+const QString CRASH = QStringLiteral(
+    "Thread 1 (Thread 0x7f1b3e0e9940 (LWP 1234)):\n"
+    "[KCrash Handler]\n"
+    "#6  0x00007f1b3c4d1f2e in KFoo::crash (this=0x0) at /home/user/foo.cpp:204\n"
+    "#7  0x00007f1b3c4d2000 in KFoo::run () from /usr/lib64/libKFoo.so.6\n"
+    "#8  0x00007f1b3a5b3000 in __libc_start_main () from /lib64/libc.so.6\n");
+
+StructuredBacktrace structuredBacktrace(const QString &trace)
+{
+    QList<BacktraceLine> lines;
+    for (const QString &line : trace.split(QLatin1Char('\n'), Qt::SkipEmptyParts)) {
+        lines << BacktraceLineGdb(line + QLatin1Char('\n'));
+    }
+    return StructuredBacktrace::fromLines(lines);
+}
+} // namespace
+
+class BugBacktraceCacheTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void init()
+    {
+        m_dir.emplace();
+        QVERIFY(m_dir->isValid());
+    }
+
+    void testRoundTrip()
+    {
+        const QDateTime changed = QDateTime::fromString(QStringLiteral("2008-02-13T02:55:08Z"), Qt::ISODate);
+        const ParseBugBacktraces::Signature signature = ParseBugBacktraces::signatureOf(structuredBacktrace(CRASH));
+        QCOMPARE(signature.frames.size(), 3);
+
+        BugBacktraceCache cache(m_dir->path());
+        QVERIFY(!cache.lookup(42, changed));
+        cache.insert(42, {changed, 3, {signature}});
+
+        const std::optional<BugBacktraceCache::Entry> entry = cache.lookup(42, changed);
+        QVERIFY(entry);
+        QCOMPARE(entry->lastChangeTime, changed);
+        QCOMPARE(entry->commentCount, qsizetype(3));
+        QCOMPARE(entry->signatures.size(), 1);
+        QCOMPARE(entry->signatures.constFirst(), signature);
+        QVERIFY(!cache.lookup(43, changed));
+    }
+
+    void testInvalidatedByChange()
+    {
+        const QDateTime changed = QDateTime::fromString(QStringLiteral("2008-02-13T02:55:08Z"), Qt::ISODate);
+        BugBacktraceCache cache(m_dir->path());
+        cache.insert(42, {changed, 1, {}});
+        QVERIFY(cache.lookup(42, changed));
+        QVERIFY(!cache.lookup(42, changed.addSecs(1)));
+        QVERIFY(!cache.lookup(42, QDateTime()));
+
+        // without a last change time there is nothing to validate against
+        cache.insert(7, {QDateTime(), 1, {}});
+        QVERIFY(!QFile::exists(m_dir->filePath(QStringLiteral("7"))));
+    }
+
+    void testCorrupt()
+    {
+        const QDateTime changed = QDateTime::fromString(QStringLiteral("2008-02-13T02:55:08Z"), Qt::ISODate);
+        BugBacktraceCache cache(m_dir->path());
+        cache.insert(42, {changed, 1, {ParseBugBacktraces::signatureOf(structuredBacktrace(CRASH))}});
+
+        QFile file(m_dir->filePath(QStringLiteral("42")));
+        QVERIFY(file.open(QFile::ReadWrite));
+        QVERIFY(file.resize(file.size() - 3));
+        file.close();
+        QVERIFY(!cache.lookup(42, changed));
+
+        QVERIFY(file.open(QFile::WriteOnly | QFile::Truncate));
+        file.write("garbage");
+        file.close();
+        QVERIFY(!cache.lookup(42, changed));
+    }
+
+    void testRatingFromCache()
+    {
+        // rating the cached signatures is the same as rating the parsed comments
+        const QDateTime changed = QDateTime::fromString(QStringLiteral("2008-02-13T02:55:08Z"), Qt::ISODate);
+        const StructuredBacktrace ourTrace = structuredBacktrace(CRASH);
+        const QList<Bugzilla::Comment::Ptr> comments{
+            new Bugzilla::Comment({{QStringLiteral("text"), QStringLiteral("Application: foo\n\n") + CRASH}}, this),
+            new Bugzilla::Comment({{QStringLiteral("text"), QStringLiteral("me too")}}, this),
+        };
+
+        ParseBugBacktraces parse(comments);
+        parse.parse();
+        QCOMPARE(parse.signatures().size(), 1);
+        QCOMPARE(parse.findDuplicate(ourTrace), ParseBugBacktraces::PerfectDuplicate);
+
+        BugBacktraceCache cache(m_dir->path());
+        cache.insert(42, {changed, comments.size(), parse.signatures()});
+        const std::optional<BugBacktraceCache::Entry> entry = cache.lookup(42, changed);
+        QVERIFY(entry);
+        QCOMPARE(ParseBugBacktraces(entry->signatures).findDuplicate(ourTrace), ParseBugBacktraces::PerfectDuplicate);
+        QCOMPARE(parse.similarity(ourTrace), 1.0);
+        QCOMPARE(ParseBugBacktraces(entry->signatures).similarity(ourTrace), 1.0);
+    }
+
+private:
+    std::optional<QTemporaryDir> m_dir;
+};
+
+QTEST_GUILESS_MAIN(BugBacktraceCacheTest)
+
+#include "bugbacktracecachetest.moc"
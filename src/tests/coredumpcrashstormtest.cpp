@@ -0,0 +1,148 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+*/
+
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <coredump.h>
+#include <crashstorm.h>
+
+using namespace std::chrono_literals;
+using namespace Qt::StringLiterals;
+
+class CoredumpCrashStormTest : public QObject
+{
+    Q_OBJECT
+
+    // As written by systemd-coredump, abbreviated.
+    static QByteArray message(const QByteArray &exe, const QByteArray &library = "libbroken.so.1"_ba)
+    {
+        return "Process 1234 (" + exe + ") of user 1000 dumped core.\n\n"
+               "Module " + library + " from rpm broken-1.0\n"
+               "Stack trace of thread 1234:\n"
+               "#0  0x00007f3c5b4a9d2c __pthread_kill_implementation (libc.so.6 + 0x8ed2c)\n"
+               "#1  0x00007f3c5b45bf86 raise (libc.so.6 + 0x40f86)\n"
+               "#2  0x00007f3c5c0a1234 _ZN6KCrash19defaultCrashHandlerEi (libKF6Crash.so.6 + 0x5234)\n"
+               "#3  0x00007f3c5b45c050 n/a (libc.so.6 + 0x41050)\n"
+               "#4  0x00007f3c5d001111 Broken::parse (" + library + " + 0x1111)\n"
+               "#5  0x00007f3c5d002222 Broken::load (" + library + " + 0x2222)\n"
+               "#6  0x000055d0c4b2a1f0 n/a (" + exe + " + 0x2a1f0)\n"
+               "#7  0x000055d0c4b2b000 main (" + exe + " + 0x2b000)\n"
+               "\n"
+               "Stack trace of thread 1235:\n"
+               "#0  0x00007f3c5b4a0000 __poll (libc.so.6 + 0x100000)\n";
+    }
+
+    static std::unique_ptr<Coredump> dump(const QByteArray &exe, const QByteArray &library = "libbroken.so.1"_ba)
+    {
+        return std::make_unique<Coredump>(QByteArray(),
+                                          Coredump::EntriesHash{
+                                              {"COREDUMP_EXE"_ba, "/usr/bin/" + exe},
+                                              {"COREDUMP_PID"_ba, "1234"_ba},
+                                              {"MESSAGE"_ba, message(exe, library)},
+                                          });
+    }
+
+private Q_SLOTS:
+    void testSignature()
+    {
+        // The crash handling frames are skipped, the addresses are dropped
+        QCOMPARE(CrashStorm::signature(message("dragon"_ba)),
+                 "Broken::parse (libbroken.so.1 + 0x1111)\n"
+                 "Broken::load (libbroken.so.1 + 0x2222)\n"
+                 "n/a (dragon + 0x2a1f0)"_ba);
+    }
+
+    void testSignatureTooShort()
+    {
+        // Only the crashing thread counts, the frames of the other threads don't fill it up
+        QVERIFY(CrashStorm::signature("Stack trace of thread 1:\n"
+                                      "#0  0x00007f3c5b45bf86 raise (libc.so.6 + 0x40f86)\n"
+                                      "#1  0x000055d0c4b2a1f0 n/a (dragon + 0x2a1f0)\n"
+                                      "\n"
+                                      "Stack trace of thread 2:\n"
+                                      "#0  0x00007f3c5b4a0000 __poll (libc.so.6 + 0x100000)\n"
+                                      "#1  0x00007f3c5b4a1000 n/a (libglib-2.0.so.0 + 0x1000)\n"
+                                      "#2  0x00007f3c5b4a2000 n/a (libglib-2.0.so.0 + 0x2000)\n"_ba)
+                    .isEmpty());
+        QVERIFY(CrashStorm::signature(QByteArray()).isEmpty());
+    }
+
+    void testCoalesceExe()
+    {
+        QTemporaryDir dir;
+        CrashStorm storm(dir.path());
+        QVERIFY(!storm.coalesce(*dump("dragon"_ba, "libone.so"_ba)));
+        // same exe, crashing elsewhere
+        QVERIFY(storm.coalesce(*dump("dragon"_ba, "libtwo.so"_ba)));
+        QVERIFY(!storm.coalesce(*dump("kate"_ba, "libthree.so"_ba)));
+    }
+
+    void testCoalesceSignature()
+    {
+        // a library update breaking different applications the same way
+        QTemporaryDir dir;
+        CrashStorm storm(dir.path());
+        const auto first = std::make_unique<Coredump>(QByteArray(),
+                                                      Coredump::EntriesHash{
+                                                          {"COREDUMP_EXE"_ba, "/usr/bin/dragon"_ba},
+                                                          {"MESSAGE"_ba,
+                                                           "#0  0x1 Broken::parse (libbroken.so.1 + 0x1111)\n"
+                                                           "#1  0x2 Broken::load (libbroken.so.1 + 0x2222)\n"
+                                                           "#2  0x3 Broken::init (libbroken.so.1 + 0x3333)\n"_ba},
+                                                      });
+        QVERIFY(!storm.coalesce(*first));
+        const auto second = std::make_unique<Coredump>(QByteArray(),
+                                                       Coredump::EntriesHash{
+                                                           {"COREDUMP_EXE"_ba, "/usr/bin/kate"_ba},
+                                                           {"MESSAGE"_ba,
+                                                            "#0  0x7 Broken::parse (libbroken.so.1 + 0x1111)\n"
+                                                            "#1  0x8 Broken::load (libbroken.so.1 + 0x2222)\n"
+                                                            "#2  0x9 Broken::init (libbroken.so.1 + 0x3333)\n"_ba},
+                                                       });
+        QVERIFY(storm.coalesce(*second));
+    }
+
+    void testCoalesceWindow()
+    {
+        QTemporaryDir dir;
+        // Shared through the directory, like between launcher processes
+        QVERIFY(!CrashStorm(dir.path(), 0ms).coalesce(*dump("dragon"_ba)));
+        QVERIFY(!CrashStorm(dir.path(), 0ms).coalesce(*dump("dragon"_ba)));
+        QVERIFY(CrashStorm(dir.path(), 1h).coalesce(*dump("dragon"_ba)));
+    }
+
+    void testRelease()
+    {
+        QTemporaryDir dir;
+        CrashStorm storm(dir.path());
+        QVERIFY(!storm.coalesce(*dump("dragon"_ba)));
+        // e.g. no slot became free, the next crash is handled instead
+        storm.release(*dump("dragon"_ba));
+        QVERIFY(!storm.coalesce(*dump("dragon"_ba)));
+        QVERIFY(storm.coalesce(*dump("dragon"_ba)));
+
+        // only groups this instance recorded are released
+        CrashStorm(dir.path()).release(*dump("dragon"_ba));
+        QVERIFY(storm.coalesce(*dump("dragon"_ba)));
+    }
+
+    void testSlots()
+    {
+        QTemporaryDir dir;
+        CrashStorm storm(dir.path(), 2min, 2);
+        auto first = storm.acquireSlot(0ms);
+        QVERIFY(first);
+        auto second = storm.acquireSlot(0ms);
+        QVERIFY(second);
+        QVERIFY(!storm.acquireSlot(0ms));
+        first.reset();
+        QVERIFY(storm.acquireSlot(0ms));
+    }
+};
+
+QTEST_GUILESS_MAIN(CoredumpCrashStormTest)
+
+#include "coredumpcrashstormtest.moc"
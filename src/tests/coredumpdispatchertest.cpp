@@ -0,0 +1,147 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+*/
+
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <coredump.h>
+
+#include "../coredump/processor/checkpoint.h"
+#include "../coredump/processor/dispatcher.h"
+
+using namespace Qt::StringLiterals;
+
+class CoredumpDispatcherTest : public QObject
+{
+    Q_OBJECT
+
+    static QByteArray cursor(int index)
+    {
+        return "s=0;i=" + QByteArray::number(index);
+    }
+
+    static std::unique_ptr<Coredump> dump(int index, uid_t uid)
+    {
+        return std::make_unique<Coredump>(cursor(index),
+                                          Coredump::EntriesHash{
+                                              {"COREDUMP_EXE"_ba, "/usr/bin/dragon"_ba},
+                                              {"COREDUMP_PID"_ba, QByteArray::number(1000 + index)},
+                                              {"COREDUMP_UID"_ba, QByteArray::number(uid)},
+                                          });
+    }
+
+    // Forwards everything, recording the cursors of the forwarded dumps.
+    static void forwardInto(Dispatcher &dispatcher, QList<QByteArray> &forwarded)
+    {
+        dispatcher.m_forward = [&forwarded](const Coredump &dump, QString &) {
+            forwarded.append(dump.m_cursor);
+            return Forward::Result::Forwarded;
+        };
+    }
+
+private Q_SLOTS:
+    void testCheckpointFile()
+    {
+        QTemporaryDir dir;
+        const QString path = dir.filePath(u"state/cursor"_s);
+        QVERIFY(Checkpoint::read(path).isEmpty());
+        Checkpoint::write(path, cursor(1));
+        QCOMPARE(Checkpoint::read(path), cursor(1));
+        Checkpoint::write(path, cursor(2));
+        QCOMPARE(Checkpoint::read(path), cursor(2));
+    }
+
+    void testTracker()
+    {
+        Checkpoint::Tracker tracker;
+        const quint64 first = tracker.add(cursor(1));
+        const quint64 second = tracker.add(cursor(2));
+        const quint64 third = tracker.add(cursor(3));
+        const quint64 fourth = tracker.add(cursor(4));
+
+        // the first dump is still pending
+        tracker.forwarded(second);
+        QVERIFY(tracker.advance().isEmpty());
+        // dropped dumps don't move the checkpoint
+        tracker.dropped(first);
+        QCOMPARE(tracker.advance(), cursor(2));
+        tracker.dropped(third);
+        QVERIFY(tracker.advance().isEmpty());
+        tracker.forwarded(fourth);
+        QCOMPARE(tracker.advance(), cursor(4));
+        QVERIFY(tracker.advance().isEmpty());
+    }
+
+    void testCheckpointHeldBackByQueuedDumps()
+    {
+        QTemporaryDir dir;
+        Dispatcher dispatcher;
+        dispatcher.m_checkpointPath = dir.filePath(u"cursor"_s);
+        QList<QByteArray> forwarded;
+        forwardInto(dispatcher, forwarded);
+
+        // More dumps of one user than are dispatched at once, followed by a dump of another user.
+        for (int i = 0; i < 6; ++i) {
+            dispatcher.enqueue(*dump(i, 1000));
+        }
+        dispatcher.enqueue(*dump(6, 1001));
+
+        dispatcher.dispatch();
+        QCOMPARE(forwarded.size(), 5);
+        QVERIFY(forwarded.contains(cursor(6)));
+        // the last two dumps of the first user are still queued
+        QCOMPARE(Checkpoint::read(dispatcher.m_checkpointPath), cursor(3));
+
+        dispatcher.dispatch();
+        QCOMPARE(forwarded.size(), 7);
+        QCOMPARE(Checkpoint::read(dispatcher.m_checkpointPath), cursor(6));
+    }
+
+    void testCheckpointSkipsUnforwardedDumps()
+    {
+        QTemporaryDir dir;
+        Dispatcher dispatcher;
+        dispatcher.m_checkpointPath = dir.filePath(u"cursor"_s);
+        QList<QByteArray> forwarded;
+        dispatcher.m_forward = [&forwarded](const Coredump &dump, QString &) {
+            if (dump.uid == 1001) {
+                return Forward::Result::NoLauncher;
+            }
+            forwarded.append(dump.m_cursor);
+            return Forward::Result::Forwarded;
+        };
+
+        dispatcher.enqueue(*dump(0, 1000));
+        dispatcher.enqueue(*dump(1, 1001));
+        dispatcher.dispatch();
+        QCOMPARE(forwarded, QList<QByteArray>{cursor(0)});
+        QCOMPARE(Checkpoint::read(dispatcher.m_checkpointPath), cursor(0));
+    }
+
+    void testCheckpointSkipsDroppedDumps()
+    {
+        QTemporaryDir dir;
+        Dispatcher dispatcher;
+        dispatcher.m_checkpointPath = dir.filePath(u"cursor"_s);
+        QList<QByteArray> forwarded;
+        forwardInto(dispatcher, forwarded);
+
+        // one dump more than are queued per user, the last one is dropped
+        constexpr int queued = 64;
+        for (int i = 0; i <= queued; ++i) {
+            dispatcher.enqueue(*dump(i, 1000));
+        }
+        while (!dispatcher.m_queues.isEmpty()) {
+            dispatcher.dispatch();
+        }
+        QCOMPARE(forwarded.size(), queued);
+        QVERIFY(!forwarded.contains(cursor(queued)));
+        QCOMPARE(Checkpoint::read(dispatcher.m_checkpointPath), cursor(queued - 1));
+    }
+};
+
+QTEST_GUILESS_MAIN(CoredumpDispatcherTest)
+
+#include "coredumpdispatchertest.moc"
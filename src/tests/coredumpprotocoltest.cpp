@@ -0,0 +1,110 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+*/
+
+#include <QTest>
+
+#include <protocol.h>
+
+using namespace Qt::StringLiterals;
+
+class CoredumpProtocolTest : public QObject
+{
+    Q_OBJECT
+
+    static Coredump::EntriesHash entries()
+    {
+        return {
+            {"COREDUMP_EXE"_ba, "/usr/bin/dragon"_ba},
+            {"COREDUMP_PID"_ba, "1234"_ba},
+            {"COREDUMP_UID"_ba, "1000"_ba},
+            {"COREDUMP_SIGNAL"_ba, "11"_ba},
+            {"COREDUMP_FILENAME"_ba, "/var/lib/systemd/coredump/core.dragon.1000.zst"_ba},
+            {"_SYSTEMD_UNIT"_ba, "systemd-coredump@1-1234-0.service"_ba},
+            {"COREDUMP_CMDLINE"_ba, "dragon --play file:///home/me/My Movie \"1\".mkv"_ba},
+            {"COREDUMP_PROC_MAPS"_ba, QByteArray(16 * 1024, 'm')},
+            {"MESSAGE"_ba, "Process 1234 (dragon) of user 1000 dumped core.\n\nStack trace of thread 1234:\n#0  0x00007f in raise (libc.so.6)"_ba},
+        };
+    }
+
+private Q_SLOTS:
+    void testRoundTrip()
+    {
+        const auto decoded = Protocol::decode(Protocol::encode(entries()));
+        QVERIFY(decoded.has_value());
+        QCOMPARE(*decoded, entries());
+
+        const Coredump dump(QByteArray(), *decoded);
+        QCOMPARE(dump.pid, 1234);
+        QCOMPARE(dump.uid, 1000U);
+        QCOMPARE(dump.exe, u"/usr/bin/dragon"_s);
+    }
+
+    void testBinary()
+    {
+        // Journal fields may contain arbitrary bytes, they must make it through unchanged.
+        QByteArray binary;
+        for (int i = 0; i < 256; ++i) {
+            binary += char(i);
+        }
+        const Coredump::EntriesHash binaryEntries{{"COREDUMP_ENVIRON"_ba, binary}, {QByteArray(), QByteArray()}};
+        const auto decoded = Protocol::decode(Protocol::encode(binaryEntries));
+        QVERIFY(decoded.has_value());
+        QCOMPARE(*decoded, binaryEntries);
+    }
+
+    void testHeader()
+    {
+        const QByteArray frame = Protocol::encode(entries());
+        QVERIFY(frame.startsWith("DKCD"));
+        QCOMPARE(quint8(frame.at(4)), Protocol::Version);
+        // The raw data plus a few bytes of CBOR heads per field, nothing gets escaped or indented.
+        qsizetype raw = 0;
+        const auto data = entries();
+        for (auto it = data.cbegin(); it != data.cend(); ++it) {
+            raw += it.key().size() + it.value().size();
+        }
+        QVERIFY(frame.size() <= 9 + raw + data.size() * 8);
+    }
+
+    void testMalformed_data()
+    {
+        QTest::addColumn<QByteArray>("frame");
+
+        const QByteArray frame = Protocol::encode(entries());
+        QByteArray wrongMagic = frame;
+        wrongMagic[0] = 'X';
+        QByteArray futureVersion = frame;
+        futureVersion[4] = char(Protocol::Version + 1);
+        QByteArray notAMap = frame.left(5);
+        notAMap += QByteArray("\0\0\0\x01\x01", 5); // payload of 1 byte: CBOR unsigned integer 1
+
+        QTest::newRow("empty") << QByteArray();
+        QTest::newRow("header only") << frame.left(9);
+        QTest::newRow("truncated") << frame.chopped(1);
+        QTest::newRow("trailing data") << frame + "x";
+        QTest::newRow("wrong magic") << wrongMagic;
+        QTest::newRow("future version") << futureVersion;
+        QTest::newRow("not a map") << notAMap;
+        QTest::newRow("json") << R"({"COREDUMP_PID": "1234"})"_ba;
+    }
+
+    void testMalformed()
+    {
+        QFETCH(QByteArray, frame);
+        QVERIFY(!Protocol::decode(frame).has_value());
+    }
+
+    void benchmarkRoundTrip()
+    {
+        const Coredump::EntriesHash data = entries();
+        QBENCHMARK {
+            QVERIFY(Protocol::decode(Protocol::encode(data)).has_value());
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(CoredumpProtocolTest)
+
+#include "coredumpprotocoltest.moc"
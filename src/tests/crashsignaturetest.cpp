@@ -0,0 +1,114 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QTest>
+
+#include "../parser/backtraceparsergdb.h"
+#include "../parser/crashsignature.h"
+
+namespace
+{
+StructuredBacktrace structuredBacktrace(const QStringList &lines)
+{
+    QList<BacktraceLine> result;
+    for (const QString &line : lines) {
+        result << BacktraceLineGdb(line + QLatin1Char('\n'));
+    }
+    return StructuredBacktrace::fromLines(result);
+}
+} // namespace
+
+class CrashSignatureTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testNormalizedFunctionName_data()
+    {
+        QTest::addColumn<QString>("name");
+        QTest::addColumn<QString>("normalized");
+
+        QTest::newRow("plain") << QStringLiteral("KFoo::crash") << QStringLiteral("KFoo::crash");
+        QTest::newRow("parameters") << QStringLiteral("KFoo::crash(QObject*, int) const") << QStringLiteral("KFoo::crash");
+        QTest::newRow("templates") << QStringLiteral("QList<QString>::append<QString const&>(QString const&)") << QStringLiteral("QList::append");
+        QTest::newRow("anonymous namespace") << QStringLiteral("(anonymous namespace)::helper(int)") << QStringLiteral("(anonymous namespace)::helper");
+        QTest::newRow("operator") << QStringLiteral("QDebug::operator<<(QString const&)") << QStringLiteral("QDebug::operator<<");
+        QTest::newRow("call operator") << QStringLiteral("Foo::operator()(int)") << QStringLiteral("Foo::operator()");
+        QTest::newRow("not an operator") << QStringLiteral("cooperator(int)") << QStringLiteral("cooperator");
+        QTest::newRow("clone") << QStringLiteral("KFoo::crash(int) [clone .isra.0]") << QStringLiteral("KFoo::crash");
+        QTest::newRow("clone suffix") << QStringLiteral("do_crash.part.0") << QStringLiteral("do_crash");
+        QTest::newRow("abi tag") << QStringLiteral("KFoo::name[abi:cxx11]() const") << QStringLiteral("KFoo::name");
+        QTest::newRow("thunk") << QStringLiteral("non-virtual thunk to KFoo::event(QEvent*)") << QStringLiteral("KFoo::event");
+#if __has_include(<cxxabi.h>)
+        QTest::newRow("mangled") << QStringLiteral("_ZN4KFoo5crashEi") << QStringLiteral("KFoo::crash");
+#endif
+    }
+
+    void testNormalizedFunctionName()
+    {
+        QFETCH(QString, name);
+        QFETCH(QString, normalized);
+        QCOMPARE(CrashSignature::normalizedFunctionName(name), normalized);
+    }
+
+    void testFromBacktrace()
+    {
+        const CrashSignature signature = CrashSignature::fromBacktrace(structuredBacktrace({
+            QStringLiteral("Thread 1 (Thread 0x7f1b3e0e9940 (LWP 1234)):"),
+            QStringLiteral("[KCrash Handler]"),
+            QStringLiteral("#4  0x00007f1b3a4e2a7c in raise () from /lib64/libc.so.6"),
+            QStringLiteral("#5  0x00007f1b3a4c8455 in abort () from /lib64/libc.so.6"),
+            QStringLiteral("#6  0x00007f1b3b0a1b3c in qFatal(char const*, ...) () from /usr/lib64/libQt6Core.so.6"),
+            QStringLiteral("#7  0x00007f1b3c4d1f2e in KFoo::check (this=0x0) at /home/user/foo.cpp:204"),
+            QStringLiteral("#8  0x00007f1b3c4d2000 in ?? () from /usr/lib64/libKFoo.so.6"),
+            QStringLiteral("#9  0x00007f1b3c4d2100 in KFoo::run (this=0x0) at /home/user/foo.cpp:20"),
+            QStringLiteral("#10 0x00007f1b3a5b3000 in main (argc=1, argv=0x7ffd) at main.cpp:12"),
+            QStringLiteral("#11 0x00007f1b3c4d2200 in after_main () at main.cpp:1"),
+        }));
+
+        // everything up to qFatal, the frame without function and everything from main on are left out
+        QCOMPARE(signature.frames(), (QStringList{QStringLiteral("KFoo::check"), QStringLiteral("KFoo::run")}));
+        QCOMPARE(signature.frameHashes().size(), 2);
+        QVERIFY(signature.hash() != 0);
+    }
+
+    void testStableAcrossBuilds()
+    {
+        // same crash, different addresses, frame numbers, arguments and clones
+        const CrashSignature a = CrashSignature::fromBacktrace(structuredBacktrace({
+            QStringLiteral("[KCrash Handler]"),
+            QStringLiteral("#6  0x00007f1b3c4d1f2e in KFoo::crash (this=0x0) at /home/user/foo.cpp:204"),
+            QStringLiteral("#7  0x00007f1b3c4d2000 in KFoo::run (this=0x0) at /home/user/foo.cpp:20"),
+        }));
+        const CrashSignature b = CrashSignature::fromBacktrace(structuredBacktrace({
+            QStringLiteral("[KCrash Handler]"),
+            QStringLiteral("#4  0x0000555555554000 in KFoo::crash(int) [clone .isra.0] () from /usr/lib/libKFoo.so.6"),
+            QStringLiteral("#5  0x0000555555555000 in KFoo::run() () from /usr/lib/libKFoo.so.6"),
+        }));
+        QCOMPARE(a.frames(), b.frames());
+        QCOMPARE(a.hash(), b.hash());
+        QCOMPARE(a, b);
+
+        const CrashSignature other = CrashSignature::fromBacktrace(structuredBacktrace({
+            QStringLiteral("[KCrash Handler]"),
+            QStringLiteral("#6  0x00007f1b3c4d1f2e in KFoo::run (this=0x0) at /home/user/foo.cpp:20"),
+            QStringLiteral("#7  0x00007f1b3c4d2000 in KFoo::crash (this=0x0) at /home/user/foo.cpp:204"),
+        }));
+        QVERIFY(other.hash() != a.hash());
+    }
+
+    void testWithoutCrashedThread()
+    {
+        const CrashSignature signature = CrashSignature::fromBacktrace(structuredBacktrace({
+            QStringLiteral("#6  0x00007f1b3c4d1f2e in KFoo::crash (this=0x0) at /home/user/foo.cpp:204"),
+        }));
+        QVERIFY(signature.isEmpty());
+        QCOMPARE(signature.hash(), quint64(0));
+    }
+};
+
+QTEST_GUILESS_MAIN(CrashSignatureTest)
+
+#include "crashsignaturetest.moc"
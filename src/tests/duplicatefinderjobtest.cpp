@@ -0,0 +1,129 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTest>
+#include <QThreadPool>
+
+#include "../bugzillaintegration/duplicatefinderjob.h"
+#include "../bugzillaintegration/libbugzilla/autotests/fakebugzillaserver.h"
+#include "../bugzillaintegration/libbugzilla/connection.h"
+#include "../parser/backtraceparsergdb.h"
+
+namespace
+{
+const QString CRASH = QStringLiteral(
+    "Thread 1 (Thread 0x7f1b3e0e9940 (LWP 1234)):\n"
+    "[KCrash Handler]\n"
+    "#6  0x00007f1b3c4d1f2e in KFoo::crash (this=0x0) at /home/user/foo.cpp:204\n"
+    "#7  0x00007f1b3c4d2000 in KFoo::run () from /usr/lib64/libKFoo.so.6\n"
+    "#8  0x00007f1b3a5b3000 in __libc_start_main () from /lib64/libc.so.6\n");
+
+const QString OTHER_CRASH = QStringLiteral(
+    "Thread 1 (Thread 0x7f1b3e0e9940 (LWP 1234)):\n"
+    "[KCrash Handler]\n"
+    "#6  0x00007f1b3c4d1f2e in KBar::crash (this=0x0) at /home/user/bar.cpp:17\n"
+    "#7  0x00007f1b3c4d2000 in KBar::exec () from /usr/lib64/libKBar.so.6\n"
+    "#8  0x00007f1b3a5b3000 in __libc_start_main () from /lib64/libc.so.6\n");
+
+StructuredBacktrace structuredBacktrace(const QString &trace)
+{
+    QList<BacktraceLine> lines;
+    for (const QString &line : trace.split(QLatin1Char('\n'), Qt::SkipEmptyParts)) {
+        lines << BacktraceLineGdb(line + QLatin1Char('\n'));
+    }
+    return StructuredBacktrace::fromLines(lines);
+}
+
+Bugzilla::Bug::Ptr resolvedBug(qint64 id, QObject *parent)
+{
+    const QJsonObject object{
+        {QStringLiteral("id"), id},
+        {QStringLiteral("status"), QStringLiteral("RESOLVED")},
+        {QStringLiteral("resolution"), QStringLiteral("FIXED")},
+        {QStringLiteral("last_change_time"), QStringLiteral("2008-02-13T02:55:08Z")},
+    };
+    return new Bugzilla::Bug(object.toVariantHash(), parent);
+}
+
+QJsonObject commentsOf(int bugId, const QString &text)
+{
+    const QJsonObject comment{
+        {QStringLiteral("bug_id"), bugId},
+        {QStringLiteral("count"), 0},
+        {QStringLiteral("creator"), QStringLiteral("tester@kde.org")},
+        {QStringLiteral("id"), bugId},
+        {QStringLiteral("text"), text},
+    };
+    return QJsonObject{{QStringLiteral("comments"), QJsonArray{comment}}};
+}
+} // namespace
+
+class DuplicateFinderJobTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase()
+    {
+        QStandardPaths::setTestModeEnabled(true);
+        // neither backtraces cached nor duplicates indexed by earlier runs
+        QVERIFY(QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).removeRecursively());
+        // The comments are analyzed in the order they arrived in, the duplicate's result comes first and the
+        // others are still on their way when it settles the search.
+        QThreadPool::globalInstance()->setMaxThreadCount(1);
+    }
+
+    void testPerfectDuplicateCancelsLaterBugs()
+    {
+        Bugzilla::FakeBugzillaServer server;
+        QVERIFY(server.listen());
+        // all bugs are fetched in one request
+        server.route("GET", QStringLiteral("/bug/1/comment"), [](const Bugzilla::FakeBugzillaServer::Request &) {
+            const QJsonObject bugs{
+                {QStringLiteral("1"), commentsOf(1, CRASH)},
+                {QStringLiteral("2"), commentsOf(2, OTHER_CRASH)},
+                {QStringLiteral("3"), commentsOf(3, OTHER_CRASH)},
+            };
+            const QJsonObject body{{QStringLiteral("bugs"), bugs}, {QStringLiteral("comments"), QJsonObject()}};
+            return Bugzilla::FakeBugzillaServer::Response{200, QJsonDocument(body).toJson(QJsonDocument::Compact)};
+        });
+
+        BugzillaManager manager(QStringLiteral("https://bugs.kde.org/"));
+        Bugzilla::setConnection(new Bugzilla::HTTPConnection(server.root()));
+
+        QObject bugParent;
+        DuplicateFinderJob job(structuredBacktrace(CRASH),
+                               {resolvedBug(1, &bugParent), resolvedBug(2, &bugParent), resolvedBug(3, &bugParent)},
+                               &manager);
+        job.setAutoDelete(false);
+        QSignalSpy scoredSpy(&job, &DuplicateFinderJob::similarityScored);
+        QSignalSpy resultSpy(&job, &KJob::result);
+        job.start();
+        QVERIFY(resultSpy.wait());
+
+        QCOMPARE(job.result().duplicate, 1);
+        QCOMPARE(job.result().parentDuplicate, 1);
+        QCOMPARE(job.result().status, Bugzilla::Bug::Status::RESOLVED);
+        QCOMPARE(server.requests().size(), 1);
+
+        // the analyses of the cancelled bugs still finish, their results must not count
+        QThreadPool::globalInstance()->waitForDone();
+        QTest::qWait(100);
+        QCOMPARE(resultSpy.size(), 1);
+        QCOMPARE(scoredSpy.size(), 1);
+        QCOMPARE(scoredSpy.constFirst().at(0).toInt(), 1);
+        QCOMPARE(scoredSpy.constFirst().at(1).toDouble(), 1.0);
+    }
+};
+
+QTEST_GUILESS_MAIN(DuplicateFinderJobTest)
+
+#include "duplicatefinderjobtest.moc"
@@ -0,0 +1,115 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "../bugzillaintegration/duplicateindex.h"
+#include "../parser/backtraceparsergdb.h"
+
+namespace
+{
+// A crash whose crashed thread has the given functions, topmost first
+CrashSignature signatureOf(const QStringList &functions)
+{
+    QList<BacktraceLine> lines{BacktraceLineGdb(QStringLiteral("[KCrash Handler]\n"))};
+    int number = 6;
+    for (const QString &function : functions) {
+        lines << BacktraceLineGdb(QStringLiteral("#%1  0x00007f1b3c4d1f2e in %2 (this=0x0) at /home/user/foo.cpp:1\n").arg(number++).arg(function));
+    }
+    return CrashSignature::fromBacktrace(StructuredBacktrace::fromLines(lines));
+}
+
+const QStringList FUNCTIONS{
+    QStringLiteral("KFoo::a"),
+    QStringLiteral("KFoo::b"),
+    QStringLiteral("KFoo::c"),
+    QStringLiteral("KFoo::d"),
+    QStringLiteral("KFoo::e"),
+};
+} // namespace
+
+class DuplicateIndexTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testLookup()
+    {
+        DuplicateIndex index;
+        const CrashSignature ours = signatureOf(FUNCTIONS);
+        QCOMPARE(ours.frames().size(), CrashSignature::Depth);
+
+        index.insert(1, {ours});
+        index.insert(2, {signatureOf({FUNCTIONS.at(0), FUNCTIONS.at(1), FUNCTIONS.at(2), QStringLiteral("KBar::x")})});
+        index.insert(3, {signatureOf({FUNCTIONS.at(0), FUNCTIONS.at(1), QStringLiteral("KBar::x"), QStringLiteral("KBar::y")})});
+        index.insert(4, {signatureOf({QStringLiteral("KBar::x")}), ours});
+        QCOMPARE(index.size(), 4);
+
+        const QList<DuplicateIndex::Match> matches = index.lookup(ours);
+        QCOMPARE(matches.size(), 3);
+        // exact first, the newer bug first among equals
+        QCOMPARE(matches.at(0).bugId, 4);
+        QVERIFY(matches.at(0).exact);
+        QCOMPARE(matches.at(1).bugId, 1);
+        QVERIFY(matches.at(1).exact);
+        // bug 3 shares only two frames
+        QCOMPARE(matches.at(2).bugId, 2);
+        QVERIFY(!matches.at(2).exact);
+        QCOMPARE(matches.at(2).sharedFrames, 3);
+
+        QVERIFY(index.lookup(CrashSignature()).isEmpty());
+    }
+
+    void testReinsertReplaces()
+    {
+        DuplicateIndex index;
+        const CrashSignature ours = signatureOf(FUNCTIONS);
+        index.insert(1, {ours});
+        index.insert(1, {signatureOf({QStringLiteral("KBar::x")})});
+        QCOMPARE(index.size(), 1);
+        QVERIFY(index.lookup(ours).isEmpty());
+
+        // without any signature the bug is forgotten
+        index.insert(1, {CrashSignature()});
+        QCOMPARE(index.size(), 0);
+    }
+
+    void testPersistence()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = dir.filePath(QStringLiteral("index"));
+        const CrashSignature ours = signatureOf(FUNCTIONS);
+
+        {
+            DuplicateIndex index(path);
+            index.load();
+            index.insert(1, {ours});
+            index.insert(2, {signatureOf({FUNCTIONS.at(0), FUNCTIONS.at(1), FUNCTIONS.at(2)})});
+            QVERIFY(index.save());
+        }
+
+        DuplicateIndex index(path);
+        index.load();
+        QCOMPARE(index.size(), 2);
+        const QList<DuplicateIndex::Match> matches = index.lookup(ours);
+        QCOMPARE(matches.size(), 2);
+        QCOMPARE(matches.at(0).bugId, 1);
+        QCOMPARE(matches.at(1).bugId, 2);
+
+        QFile file(path);
+        QVERIFY(file.open(QFile::ReadWrite));
+        QVERIFY(file.resize(file.size() - 5));
+        file.close();
+        index.load();
+        QCOMPARE(index.size(), 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(DuplicateIndexTest)
+
+#include "duplicateindextest.moc"
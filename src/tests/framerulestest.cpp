@@ -0,0 +1,99 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QTest>
+
+#include "../parser/framerules.h"
+
+Q_DECLARE_METATYPE(FrameRules::Categories)
+
+class FrameRulesTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testBuiltin_data()
+    {
+        QTest::addColumn<QString>("function");
+        QTest::addColumn<QString>("library");
+        QTest::addColumn<FrameRules::Categories>("categories");
+
+        QTest::newRow("plain") << QStringLiteral("KFoo::bar") << QStringLiteral("/usr/lib/libKFoo.so.6") << FrameRules::Categories();
+        QTest::newRow("start_thread") << QStringLiteral("start_thread") << QString() << FrameRules::Categories(FrameRules::StackBase);
+        QTest::newRow("main") << QStringLiteral("main") << QString() << FrameRules::Categories(FrameRules::StackBase);
+        QTest::newRow("not main") << QStringLiteral("mainWindow") << QString() << FrameRules::Categories();
+        QTest::newRow("notify") << QStringLiteral("QCoreApplicationPrivate::notify_helper") << QString() << FrameRules::Categories(FrameRules::StackBase);
+        QTest::newRow("abort") << QStringLiteral("abort") << QString()
+                               << FrameRules::Categories(FrameRules::StackTop | FrameRules::NotUseful);
+        QTest::newRow("qt_assert_x") << QStringLiteral("qt_assert_x") << QString() << FrameRules::Categories(FrameRules::StackTop);
+        QTest::newRow("libc") << QStringLiteral("__GI_raise") << QStringLiteral("/lib64/libc.so.6") << FrameRules::Categories(FrameRules::Ignored);
+        QTest::newRow("glibc prefix") << QStringLiteral("*__GI_abort") << QString()
+                                      << FrameRules::Categories(FrameRules::StackTop | FrameRules::Ignored);
+        QTest::newRow("_tmain") << QStringLiteral("wmain_tmain_x") << QString() << FrameRules::Categories(FrameRules::Ignored);
+        QTest::newRow("detach") << QStringLiteral("QList<int>::detach") << QString()
+                                << FrameRules::Categories(FrameRules::NotUseful | FrameRules::NotUsefulForSearch);
+        QTest::newRow("ref suffix") << QStringLiteral("KFoo::ref") << QString() << FrameRules::Categories(FrameRules::NotUseful);
+        QTest::newRow("ref infix") << QStringLiteral("KFoo::refresh") << QString() << FrameRules::Categories();
+        QTest::newRow("QHash") << QStringLiteral("QHash<int, int>::insert") << QString() << FrameRules::Categories(FrameRules::NotUsefulForSearch);
+    }
+
+    void testBuiltin()
+    {
+        QFETCH(QString, function);
+        QFETCH(QString, library);
+        QFETCH(FrameRules::Categories, categories);
+        QCOMPARE(FrameRules::instance().classify(function, library), categories);
+    }
+
+    void testCustomRules()
+    {
+        FrameRules rules;
+        QString errorString;
+        QVERIFY(rules.addRules(u"# comment\n"
+                               u"\n"
+                               u"  StackBase function equals my main\n"
+                               u"Ignored library startsAndEndsWith libsystem_*.dylib\n"
+                               u"NotUseful function contains Helper\n",
+                               &errorString));
+        QVERIFY(errorString.isEmpty());
+
+        QCOMPARE(rules.classify(u"my main", u""), FrameRules::Categories(FrameRules::StackBase));
+        QCOMPARE(rules.classify(u"my main2", u""), FrameRules::Categories());
+        QCOMPARE(rules.classify(u"", u"libsystem_kernel.dylib"), FrameRules::Categories(FrameRules::Ignored));
+        QCOMPARE(rules.classify(u"", u"libsystem_.dylib"), FrameRules::Categories(FrameRules::Ignored));
+        QCOMPARE(rules.classify(u"", u"libsystem_dylib"), FrameRules::Categories());
+        QCOMPARE(rules.classify(u"", u"libsystem_kernel.so"), FrameRules::Categories());
+        QCOMPARE(rules.classify(u"KFooHelperPrivate::run", u""), FrameRules::Categories(FrameRules::NotUseful));
+        // library rules don't apply to functions
+        QCOMPARE(rules.classify(u"libsystem_kernel.dylib", u""), FrameRules::Categories());
+
+        // rules can be added after the fact
+        QVERIFY(rules.addRules(u"StackTop function endsWith _fail"));
+        QCOMPARE(rules.classify(u"assert_fail", u""), FrameRules::Categories(FrameRules::StackTop));
+        QCOMPARE(rules.classify(u"my main", u""), FrameRules::Categories(FrameRules::StackBase));
+    }
+
+    void testSyntaxErrors()
+    {
+        FrameRules rules;
+        QString errorString;
+        QVERIFY(!rules.addRules(u"Bogus function equals foo\n"
+                                u"StackBase symbol equals foo\n"
+                                u"StackBase function resembles foo\n"
+                                u"StackBase function equals\n"
+                                u"Ignored library startsAndEndsWith nostar\n"
+                                u"StackTop function equals bar\n",
+                                &errorString));
+        QCOMPARE(errorString.count(QLatin1Char('\n')), 5);
+        QVERIFY(errorString.startsWith(QLatin1String("line 1:")));
+        // valid lines are still added
+        QCOMPARE(rules.classify(u"bar", u""), FrameRules::Categories(FrameRules::StackTop));
+        QCOMPARE(rules.classify(u"foo", u""), FrameRules::Categories());
+    }
+};
+
+QTEST_GUILESS_MAIN(FrameRulesTest)
+
+#include "framerulestest.moc"
@@ -4,9 +4,49 @@
     SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
 */
 
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
 #include <QTest>
 
 #include "../parser/backtraceparsergdb.h"
+#include "../parser/gdbframetokenizer.h"
+#include "../parser/symboltable.h"
+
+namespace
+{
+// The regular expression BacktraceLineGdb::parse() used before the tokenizer. Kept as reference.
+const QRegularExpression &legacyFrameExpression()
+{
+    static const QRegularExpression expression(QRegularExpression::anchoredPattern(QStringLiteral("#([0-9]+)"
+                                                                                                  "[\\s]+(?:0x[0-9a-f]+[\\s]+in[\\s]+)?"
+                                                                                                  "((?:\\(anonymous namespace\\)::)?[^\\(]+)?"
+                                                                                                  "(?:\\(.*\\))?"
+                                                                                                  "[\\s]+(?:const[\\s]+)?"
+                                                                                                  "\\(.*\\)"
+                                                                                                  "([\\s]+"
+                                                                                                  "(from|at)[\\s]+"
+                                                                                                  "(.+)"
+                                                                                                  ")?\n")),
+                                               QRegularExpression::DotMatchesEverythingOption);
+    return expression;
+}
+
+// A frame from a template heavy application with a multi kilobyte argument list.
+QString longTemplateFrame()
+{
+    QString type = QStringLiteral("int");
+    for (int i = 0; i < 5; ++i) {
+        type = QStringLiteral("std::pair<QHash<QString, %1>, std::vector<std::shared_ptr<%1>>>").arg(type);
+    }
+    QString arguments;
+    for (int i = 0; i < 8; ++i) {
+        arguments += QStringLiteral("arg%1=std::function<void(%2 const&)> (%3) = {...}, ").arg(QString::number(i), type, QString::number(i));
+    }
+    arguments.chop(2);
+    return QStringLiteral("#12 0x00007f468b177bfa in KFoo::Private::apply<%1> (this=0x0, %2) at /usr/src/debug/kfoo/src/foo.cpp:310\n").arg(type, arguments);
+}
+} // namespace
 
 class GdbBacktraceLineTest : public QObject
 {
@@ -125,6 +165,144 @@ private Q_SLOTS:
         QCOMPARE(line.rating(), BacktraceLine::InvalidRating);
         QCOMPARE(line.toString(), input);
     }
+
+    void testSharedBuffer()
+    {
+        const QString first = QStringLiteral("Thread 35 (Thread 0x7f77f57fa700 (LWP 8133)):\n");
+        const QString second = QStringLiteral("#41 0x00007f4684ae4e87 in g_main_context_dispatch () from /usr/lib64/libglib-2.0.so.0\n");
+
+        BacktraceLine::BufferPtr buffer(new BacktraceLine::Buffer);
+        BacktraceLineGdb firstLine(buffer, buffer->append(first), first.size());
+        BacktraceLineGdb secondLine(buffer, buffer->append(second), second.size());
+        // The lines refer into the buffer, they must not have copied anything.
+        QCOMPARE(secondLine.lineView().data(), buffer->text().constData() + first.size());
+
+        // Growing the buffer reallocates it, the lines must still resolve correctly.
+        for (int i = 0; i < 1000; ++i) {
+            buffer->append(second);
+        }
+        QCOMPARE(firstLine.type(), BacktraceLine::ThreadStart);
+        QCOMPARE(firstLine.toString(), first);
+        QCOMPARE(firstLine.functionName(), "??");
+        QCOMPARE(secondLine.type(), BacktraceLine::StackFrame);
+        QCOMPARE(secondLine.toString(), second);
+        QCOMPARE(secondLine.functionName(), "g_main_context_dispatch");
+        QCOMPARE(secondLine.libraryName(), "/usr/lib64/libglib-2.0.so.0");
+        QCOMPARE(secondLine.fileName(), "");
+        QCOMPARE(secondLine.rating(), BacktraceLine::MissingSourceFile);
+    }
+
+    void testSymbolIds()
+    {
+        const BacktraceLineGdb first(QStringLiteral("#4  0x00007f5e8b6d3ee1 in QCoreApplication::notify (this=0x1) from /usr/lib/libQt6Core.so.6\n"));
+        const BacktraceLineGdb second(QStringLiteral("#9  0x00007f5e8b6d3ee1 in QCoreApplication::notify (this=0x2) from /usr/lib/libQt6Core.so.6\n"));
+        const BacktraceLineGdb other(QStringLiteral("#2  0x00007f5e8b6d3ee1 in QCoreApplication::exec () from /usr/lib/libQt6Gui.so.6\n"));
+        const BacktraceLineGdb thread(QStringLiteral("Thread 35 (Thread 0x7f77f57fa700 (LWP 8133)):\n"));
+
+        QCOMPARE(first.functionId(), second.functionId());
+        QCOMPARE(first.libraryId(), second.libraryId());
+        QVERIFY(first.functionId() != other.functionId());
+        QVERIFY(first.libraryId() != other.libraryId());
+        QCOMPARE(SymbolTable::name(first.functionId()), first.functionName());
+        QCOMPARE(SymbolTable::name(other.libraryId()), other.libraryName());
+        QCOMPARE(SymbolTable::name(thread.functionId()), QStringLiteral("??"));
+        QCOMPARE(thread.libraryId(), SymbolTable::EmptyId);
+        QCOMPARE(SymbolTable::intern(QStringView()), SymbolTable::EmptyId);
+    }
+
+    void testTokenizerMatchesRegex_data()
+    {
+        QTest::addColumn<QString>("input");
+
+        // Every line of the parser test data, joined the same way BacktraceParserGdb::newLine does.
+        const QDir dataDir(QFINDTESTDATA("backtraceparsertest/backtraceparsertest_data"));
+        const auto files = dataDir.entryList({QStringLiteral("test_*")}, QDir::Files);
+        QVERIFY(!files.isEmpty());
+        for (const auto &fileName : files) {
+            QFile file(dataDir.filePath(fileName));
+            QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+            QString buffer;
+            int row = 0;
+            auto addRow = [&] {
+                if (!buffer.isEmpty()) {
+                    QTest::addRow("%s:%d", qPrintable(fileName), row) << buffer;
+                }
+            };
+            while (!file.atEnd()) {
+                const QString line = QString::fromUtf8(file.readLine());
+                ++row;
+                if (!buffer.isEmpty() && (line.startsWith(QLatin1Char(' ')) || line.startsWith(QLatin1Char('\t')))) {
+                    buffer += line;
+                    continue;
+                }
+                addRow();
+                buffer = line;
+            }
+            addRow();
+        }
+        QTest::newRow("long-template-frame") << longTemplateFrame();
+        QTest::newRow("no-function") << QStringLiteral("#13 0x00007fe6059971b1 in  () at /usr/lib/libglib-2.0.so.0\n");
+        QTest::newRow("signature-and-arguments") << QStringLiteral("#3 0x1 in foo(int) const (this=0x0) from /usr/lib/libfoo.so\n");
+        QTest::newRow("deleted-library") << QStringLiteral("#3 0x1 in foo () from /usr/lib/libfoo.so (deleted)\n");
+        QTest::newRow("address-without-function") << QStringLiteral("#3 0x1 in (x)\n");
+    }
+
+    void testTokenizerMatchesRegex()
+    {
+        QFETCH(QString, input);
+
+        const auto match = legacyFrameExpression().match(input);
+        const auto frame = tokenizeGdbFrame(input);
+        QCOMPARE(frame.has_value(), match.hasMatch());
+        if (!frame) {
+            return;
+        }
+
+        QCOMPARE(frame->frameNumber, match.captured(1).toInt());
+        QCOMPARE(frame->functionName.toString(), match.captured(2).trimmed());
+        if (match.captured(3).isEmpty()) {
+            QCOMPARE(frame->locationKind, GdbFrameTokens::LocationKind::None);
+            QVERIFY(frame->location.isEmpty());
+        } else {
+            QCOMPARE(frame->locationKind,
+                     match.captured(4) == QLatin1String("at") ? GdbFrameTokens::LocationKind::At : GdbFrameTokens::LocationKind::From);
+            QCOMPARE(frame->location.toString(), match.captured(5));
+        }
+        QVERIFY(frame->arguments.startsWith(QLatin1Char('(')));
+        QVERIFY(frame->arguments.endsWith(QLatin1Char(')')));
+    }
+
+    void benchmarkLongTemplateFrame_data()
+    {
+        QTest::addColumn<bool>("regex");
+        QTest::newRow("regex") << true;
+        QTest::newRow("tokenizer") << false;
+    }
+
+    void benchmarkLongTemplateFrame()
+    {
+        QFETCH(bool, regex);
+
+        const QString input = longTemplateFrame();
+        if (regex) {
+            QBENCHMARK {
+                QVERIFY(legacyFrameExpression().match(input).hasMatch());
+            }
+        } else {
+            QBENCHMARK {
+                QVERIFY(tokenizeGdbFrame(input).has_value());
+            }
+        }
+    }
+
+    void benchmarkParseLine()
+    {
+        const QString input = longTemplateFrame();
+        QBENCHMARK {
+            BacktraceLineGdb line(input);
+            QCOMPARE(line.type(), BacktraceLine::StackFrame);
+        }
+    }
 };
 
 QTEST_GUILESS_MAIN(GdbBacktraceLineTest)
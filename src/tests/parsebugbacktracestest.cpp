@@ -0,0 +1,118 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include "../bugzillaintegration/parsebugbacktraces.h"
+#include "../parser/backtraceparsergdb.h"
+
+namespace
+{
+const QString CRASHED_THREAD = QStringLiteral(
+    "Thread 1 (Thread 0x7f1b3e0e9940 (LWP 1234)):\n"
+    "[KCrash Handler]\n"
+    "#6  0x00007f1b3c4d1f2e in KFoo::crash (this=0x0) at /home/user/foo.cpp:204\n"
+    "#7  0x00007f1b3c4d2000 in KFoo::run () from /usr/lib64/libKFoo.so.6\n"
+    "#8  0x00007f1b3a5b3000 in __libc_start_main () from /lib64/libc.so.6\n");
+
+const QString OTHER_THREAD = QStringLiteral(
+    "Thread 2 (Thread 0x7f1b2c2d3700 (LWP 1235)):\n"
+    "#0  0x00007f1b3a5b3d2d in poll () from /lib64/libc.so.6\n"
+    "#1  0x00007f1b36d0f3e4 in g_main_context_iterate () from /usr/lib64/libglib-2.0.so.0\n");
+
+// Like the parser's lines, empty lines included.
+StructuredBacktrace structuredBacktrace(const QString &trace)
+{
+    QList<BacktraceLine> lines;
+    for (const QString &line : trace.split(QLatin1Char('\n'))) {
+        lines << BacktraceLineGdb(line + QLatin1Char('\n'));
+    }
+    lines.removeLast(); // after the trailing newline
+    return StructuredBacktrace::fromLines(lines);
+}
+
+// The crashed thread without its last frame
+QString truncated(const QString &thread)
+{
+    return thread.left(thread.lastIndexOf(QLatin1Char('#')));
+}
+} // namespace
+
+class ParseBugBacktracesTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testSignature()
+    {
+        const ParseBugBacktraces::Signature signature = ParseBugBacktraces::signatureOf(structuredBacktrace(CRASHED_THREAD + QLatin1Char('\n') + OTHER_THREAD));
+        QCOMPARE(signature.frames.size(), 3);
+        QCOMPARE(signature.frames.constFirst().number, 6);
+        QVERIFY(signature.blockEnded);
+
+        const ParseBugBacktraces::Signature unterminated = ParseBugBacktraces::signatureOf(structuredBacktrace(CRASHED_THREAD));
+        QCOMPARE(unterminated.frames, signature.frames);
+        QVERIFY(!unterminated.blockEnded);
+
+        QVERIFY(ParseBugBacktraces::signatureOf(structuredBacktrace(OTHER_THREAD)).frames.isEmpty());
+    }
+
+    void testRating_data()
+    {
+        QTest::addColumn<QString>("ours");
+        QTest::addColumn<QString>("theirs");
+        QTest::addColumn<int>("rating");
+
+        const QString complete = CRASHED_THREAD + QLatin1Char('\n') + OTHER_THREAD;
+        const QString shorter = truncated(CRASHED_THREAD) + QLatin1Char('\n') + OTHER_THREAD;
+        QTest::newRow("same") << complete << complete << int(ParseBugBacktraces::PerfectDuplicate);
+        QTest::newRow("other threads don't matter") << complete << CRASHED_THREAD << int(ParseBugBacktraces::PerfectDuplicate);
+        // Comments are often cut short (or the trace was), the frames that are there match.
+        QTest::newRow("cut short") << complete << truncated(CRASHED_THREAD) << int(ParseBugBacktraces::PerfectDuplicate);
+        QTest::newRow("ours cut short") << truncated(CRASHED_THREAD) << complete << int(ParseBugBacktraces::PerfectDuplicate);
+        // A crashed thread that ended with fewer frames is a different crash, 2 of 3 frames match.
+        QTest::newRow("shorter thread") << complete << shorter << int(ParseBugBacktraces::MaybeDuplicate);
+        QTest::newRow("ours shorter") << shorter << complete << int(ParseBugBacktraces::MaybeDuplicate);
+        QTest::newRow("no crash") << complete << OTHER_THREAD << int(ParseBugBacktraces::NoDuplicate);
+    }
+
+    void testRating()
+    {
+        QFETCH(QString, ours);
+        QFETCH(QString, theirs);
+        QFETCH(int, rating);
+
+        const ParseBugBacktraces::Signature signature = ParseBugBacktraces::signatureOf(structuredBacktrace(theirs));
+        QList<ParseBugBacktraces::Signature> signatures;
+        if (!signature.frames.isEmpty()) {
+            signatures << signature;
+        }
+        QCOMPARE(int(ParseBugBacktraces(signatures).findDuplicate(structuredBacktrace(ours))), rating);
+    }
+
+    void testNamesStayInSession()
+    {
+        // Several threads, so the parser would have several blocks to parse in parallel.
+        const QString trace = CRASHED_THREAD + QLatin1Char('\n') + OTHER_THREAD + QLatin1Char('\n')
+            + QStringLiteral(
+                  "Thread 3 (Thread 0x7f1b2c2d3800 (LWP 1236)):\n"
+                  "#0  0x00007f1b3a5b3d2d in KSessionOnly::wait () from /usr/lib64/libKSessionOnly.so.6\n");
+        QObject parent;
+        const QList<Bugzilla::Comment::Ptr> comments{new Bugzilla::Comment({{QStringLiteral("text"), trace}}, &parent)};
+
+        const qsizetype size = SymbolTable::size();
+        {
+            SymbolTable::Session session;
+            ParseBugBacktraces parser(comments);
+            parser.parse();
+            QCOMPARE(parser.signatures().size(), 1);
+        }
+        QCOMPARE(SymbolTable::size(), size);
+    }
+};
+
+QTEST_GUILESS_MAIN(ParseBugBacktracesTest)
+
+#include "parsebugbacktracestest.moc"
@@ -0,0 +1,122 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTest>
+
+#include "../parser/backtraceparsergdb.h"
+#include "../parser/structuredbacktrace.h"
+
+namespace
+{
+QList<BacktraceLine> gdbLines(const QStringList &lines)
+{
+    QList<BacktraceLine> result;
+    for (const QString &line : lines) {
+        result << BacktraceLineGdb(line);
+    }
+    return result;
+}
+} // namespace
+
+class StructuredBacktraceTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testThreads()
+    {
+        const StructuredBacktrace backtrace = StructuredBacktrace::fromLines(gdbLines({
+            QStringLiteral("Thread 2 (Thread 0x7f1b2c2d3700 (LWP 1235)):\n"),
+            QStringLiteral("#0  0x00007f1b3a5b3d2d in poll () from /lib64/libc.so.6\n"),
+            QStringLiteral("#1  0x00007f1b36d0f3e4 in g_main_context_iterate () from /usr/lib64/libglib-2.0.so.0\n"),
+            QStringLiteral("\n"),
+            QStringLiteral("Thread 1 (Thread 0x7f1b3e0e9940 (LWP 1234)):\n"),
+            QStringLiteral("[KCrash Handler]\n"),
+            QStringLiteral("#6  0x00007f1b3c4d1f2e in KFoo::crash (this=0x0) at /home/user/foo.cpp:204\n"),
+            QStringLiteral("#7  0x00007f1b3c4d2000 in ?? () from /usr/lib64/libKFoo.so.6\n"),
+            QStringLiteral("#8  0x00007f1b3a5b3000 in __libc_start_main () from /lib64/libc.so.6\n"),
+        }));
+
+        QCOMPARE(backtrace.threads().size(), 2);
+        QVERIFY(backtrace.crashedThread());
+        QCOMPARE(backtrace.crashedThread(), &backtrace.threads().at(1));
+
+        const StructuredBacktrace::Thread &idle = backtrace.threads().at(0);
+        QCOMPARE(idle.header.type(), BacktraceLine::ThreadStart);
+        QCOMPARE(idle.crashFrame, -1);
+        QCOMPARE(idle.frames.size(), 2);
+        QCOMPARE(idle.frames.at(1).line.functionName(), QStringLiteral("g_main_context_iterate"));
+
+        const StructuredBacktrace::Thread &crashed = backtrace.threads().at(1);
+        QCOMPARE(crashed.crashFrame, 0);
+        QCOMPARE(crashed.frames.size(), 3);
+        QCOMPARE(crashed.frames.at(0).line.frameNumber(), 6);
+        QCOMPARE(crashed.frames.at(0).module, -1);
+
+        // libc appears twice but is one module
+        QCOMPARE(backtrace.modules().size(), 3);
+        QCOMPARE(idle.frames.at(0).module, crashed.frames.at(2).module);
+        const StructuredBacktrace::Module &kfoo = backtrace.modules().at(crashed.frames.at(1).module);
+        QCOMPARE(kfoo.path, QStringLiteral("/usr/lib64/libKFoo.so.6"));
+        QVERIFY(kfoo.missingDebugSymbols);
+    }
+
+    void testWithoutThreadHeaders()
+    {
+        const StructuredBacktrace backtrace = StructuredBacktrace::fromLines(gdbLines({
+            QStringLiteral("[KCrash Handler]\n"),
+            QStringLiteral("#5  0x00007f1b3c4d1f2e in main (argc=1, argv=0x7ffd) at main.cpp:12\n"),
+        }));
+        QCOMPARE(backtrace.threads().size(), 1);
+        QCOMPARE(backtrace.threads().constFirst().header.type(), BacktraceLine::Unknown);
+        QVERIFY(backtrace.crashedThread());
+        QCOMPARE(backtrace.crashedThread()->frames.size(), 1);
+    }
+
+    void testJson()
+    {
+        const StructuredBacktrace backtrace = StructuredBacktrace::fromLines(gdbLines({
+            QStringLiteral("Thread 1 (Thread 0x7f1b3e0e9940 (LWP 1234)):\n"),
+            QStringLiteral("[KCrash Handler]\n"),
+            QStringLiteral("#6  0x00007f1b3c4d1f2e in operator\"\"_x<\\é\t> (this=0x0) at /home/user/foo.cpp:204\n"),
+            QStringLiteral("#7  0x00007f1b3c4d2000 in ?? () from /usr/lib64/libKFoo.so.6\n"),
+        }));
+
+        QJsonParseError error;
+        const QJsonDocument document = QJsonDocument::fromJson(backtrace.toJson(), &error);
+        QCOMPARE(error.error, QJsonParseError::NoError);
+
+        const QJsonArray threads = document.object().value(QLatin1String("threads")).toArray();
+        QCOMPARE(threads.size(), 1);
+        const QJsonObject thread = threads.at(0).toObject();
+        QCOMPARE(thread.value(QLatin1String("header")).toString(), QStringLiteral("Thread 1 (Thread 0x7f1b3e0e9940 (LWP 1234)):"));
+        QCOMPARE(thread.value(QLatin1String("crashFrame")).toInt(), 0);
+
+        const QJsonArray frames = thread.value(QLatin1String("frames")).toArray();
+        QCOMPARE(frames.size(), 2);
+        const QJsonObject first = frames.at(0).toObject();
+        QCOMPARE(first.value(QLatin1String("number")).toInt(), 6);
+        QCOMPARE(first.value(QLatin1String("function")).toString(), QStringLiteral("operator\"\"_x<\\é\t>"));
+        QCOMPARE(first.value(QLatin1String("file")).toString(), QStringLiteral("/home/user/foo.cpp:204"));
+        QCOMPARE(first.value(QLatin1String("rating")).toString(), QStringLiteral("Good"));
+        QVERIFY(!first.contains(QLatin1String("module")));
+        const QJsonObject second = frames.at(1).toObject();
+        QCOMPARE(second.value(QLatin1String("function")).toString(), QStringLiteral("??"));
+        QCOMPARE(second.value(QLatin1String("module")).toInt(), 0);
+        QCOMPARE(second.value(QLatin1String("rating")).toString(), QStringLiteral("MissingFunction"));
+
+        const QJsonArray modules = document.object().value(QLatin1String("modules")).toArray();
+        QCOMPARE(modules.size(), 1);
+        QCOMPARE(modules.at(0).toObject().value(QLatin1String("path")).toString(), QStringLiteral("/usr/lib64/libKFoo.so.6"));
+        QCOMPARE(modules.at(0).toObject().value(QLatin1String("missingDebugSymbols")).toBool(), true);
+    }
+};
+
+QTEST_GUILESS_MAIN(StructuredBacktraceTest)
+
+#include "structuredbacktracetest.moc"
@@ -0,0 +1,122 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include "../parser/backtraceparsergdb.h"
+#include "../parser/structuredbacktrace.h"
+#include "../parser/symboltable.h"
+
+namespace
+{
+// A backtrace whose function and library names are unique to run
+StructuredBacktrace parse(int run)
+{
+    QList<BacktraceLine> lines{BacktraceLineGdb(QStringLiteral("[KCrash Handler]\n"))};
+    for (int frame = 6; frame < 16; ++frame) {
+        lines << BacktraceLineGdb(QStringLiteral("#%1  0x00007f1b3c4d1f2e in Run%2::function%1 () from /usr/lib64/librun%2.so.6\n").arg(frame).arg(run));
+    }
+    return StructuredBacktrace::fromLines(lines);
+}
+
+// Feeds a text to a parser the way drkonqi-backtrace-analyzer does
+class TextGenerator : public QObject
+{
+    Q_OBJECT
+public:
+    void sendText(const QString &text)
+    {
+        Q_EMIT starting();
+        const QStringList lines = text.split(QLatin1Char('\n'));
+        for (const QString &line : lines) {
+            Q_EMIT newLine(line + QLatin1Char('\n'));
+        }
+        Q_EMIT newLine(QString());
+    }
+
+Q_SIGNALS:
+    void starting();
+    void newLine(const QString &line);
+};
+} // namespace
+
+class SymbolTableTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testIntern()
+    {
+        const SymbolTable::Id id = SymbolTable::intern(QStringLiteral("KFoo::intern"));
+        QCOMPARE(SymbolTable::intern(QStringLiteral("KFoo::intern")), id);
+        QVERIFY(SymbolTable::intern(QStringLiteral("KFoo::other")) != id);
+        QCOMPARE(SymbolTable::name(id), QStringLiteral("KFoo::intern"));
+        QCOMPARE(SymbolTable::intern(QString()), SymbolTable::EmptyId);
+    }
+
+    void testSession()
+    {
+        const SymbolTable::Id known = SymbolTable::intern(QStringLiteral("KFoo::known"));
+        const qsizetype size = SymbolTable::size();
+        {
+            SymbolTable::Session session;
+            // names of the table keep their ids
+            QCOMPARE(SymbolTable::intern(QStringLiteral("KFoo::known")), known);
+            const SymbolTable::Id id = SymbolTable::intern(QStringLiteral("KFoo::sessionOnly"));
+            QVERIFY(id != known);
+            QCOMPARE(SymbolTable::intern(QStringLiteral("KFoo::sessionOnly")), id);
+            QCOMPARE(SymbolTable::name(id), QStringLiteral("KFoo::sessionOnly"));
+            QCOMPARE(SymbolTable::size(), size);
+        }
+        QCOMPARE(SymbolTable::size(), size);
+    }
+
+    void testBoundedAcrossParses()
+    {
+        // e.g. the backtraces of one bug after another
+        parse(0);
+        const qsizetype size = SymbolTable::size();
+        for (int run = 1; run <= 100; ++run) {
+            SymbolTable::Session session;
+            const StructuredBacktrace backtrace = parse(run);
+            QCOMPARE(backtrace.crashedThread()->frames.size(), 10);
+            QCOMPARE(backtrace.modules().size(), 1);
+            QCOMPARE(SymbolTable::name(backtrace.crashedThread()->frames.constFirst().line.functionId()), QStringLiteral("Run%1::function6").arg(run));
+        }
+        QCOMPARE(SymbolTable::size(), size);
+    }
+
+    void testBoundedAcrossParserRuns()
+    {
+        // e.g. drkonqi-backtrace-analyzer going through a corpus, one file after another
+        auto analyze = [](int run) {
+            SymbolTable::Session session;
+            TextGenerator generator;
+            BacktraceParserGdb parser;
+            parser.setThreadPool(nullptr);
+            parser.connectToGenerator(&generator);
+            QString text = QStringLiteral("Thread 1 (Thread 0x7f1b3e0e9940 (LWP 1234)):\n[KCrash Handler]\n");
+            for (int frame = 6; frame < 16; ++frame) {
+                text += QStringLiteral("#%1  0x00007f1b3c4d1f2e in File%2::function%1 () from /usr/lib64/libfile%2.so.6\n").arg(frame).arg(run);
+            }
+            text += QStringLiteral("\nThread 2 (Thread 0x7f1b2c2d3700 (LWP 1235)):\n#0  0x00007f1b3a5b3d2d in File%1::poll () from /lib64/libc.so.6\n").arg(run);
+            generator.sendText(text);
+            QCOMPARE(parser.firstValidFunctions().value(0), QStringLiteral("File%1::function6").arg(run));
+            parser.backtraceUsefulness();
+            parser.simplifiedBacktrace();
+        };
+
+        analyze(0);
+        const qsizetype size = SymbolTable::size();
+        for (int run = 1; run <= 100; ++run) {
+            analyze(run);
+        }
+        QCOMPARE(SymbolTable::size(), size);
+    }
+};
+
+QTEST_GUILESS_MAIN(SymbolTableTest)
+
+#include "symboltabletest.moc"